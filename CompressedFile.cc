@@ -0,0 +1,474 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "ResizerConfig.hh"
+#include "Machine.hh"
+#include "Vector.hh"
+#include "CompressedFile.hh"
+
+#if ZLIB
+#include <zlib.h>
+#endif
+
+namespace sta {
+
+using std::min;
+using std::max;
+
+bool
+isCompressedFilename(const char *filename)
+{
+  size_t length = strlen(filename);
+  return length > 3
+    && strcmp(filename + length - 3, ".gz") == 0;
+}
+
+////////////////////////////////////////////////////////////////
+
+#if FOPENCOOKIE
+
+// The cookie functions have the fopencookie signatures.
+FILE *
+openCookieStream(void *cookie,
+		 const char *mode,
+		 CookieRead *read,
+		 CookieWrite *write,
+		 CookieClose *close)
+{
+  cookie_io_functions_t functions = {read, write, nullptr, close};
+  return fopencookie(cookie, mode, functions);
+}
+
+#elif FUNOPEN
+
+// funopen uses int sizes, so adapt the cookie functions.
+class FunopenCookie
+{
+public:
+  void *cookie_;
+  CookieRead *read_;
+  CookieWrite *write_;
+  CookieClose *close_;
+};
+
+static int
+funopenRead(void *cookie,
+	    char *buffer,
+	    int size)
+{
+  FunopenCookie *funopen_cookie = static_cast<FunopenCookie*>(cookie);
+  return funopen_cookie->read_(funopen_cookie->cookie_, buffer, size);
+}
+
+static int
+funopenWrite(void *cookie,
+	     const char *data,
+	     int size)
+{
+  FunopenCookie *funopen_cookie = static_cast<FunopenCookie*>(cookie);
+  return funopen_cookie->write_(funopen_cookie->cookie_, data, size);
+}
+
+static int
+funopenClose(void *cookie)
+{
+  FunopenCookie *funopen_cookie = static_cast<FunopenCookie*>(cookie);
+  int result = funopen_cookie->close_(funopen_cookie->cookie_);
+  delete funopen_cookie;
+  return result;
+}
+
+FILE *
+openCookieStream(void *cookie,
+		 const char *mode,
+		 CookieRead *read,
+		 CookieWrite *write,
+		 CookieClose *close)
+{
+  FunopenCookie *funopen_cookie = new FunopenCookie{cookie, read, write,
+						    close};
+  bool reading = (mode[0] == 'r');
+  FILE *file = funopen(funopen_cookie,
+		       reading ? funopenRead : nullptr,
+		       reading ? nullptr : funopenWrite,
+		       nullptr, funopenClose);
+  if (file == nullptr)
+    delete funopen_cookie;
+  return file;
+}
+
+#else
+
+FILE *
+openCookieStream(void *,
+		 const char *,
+		 CookieRead *,
+		 CookieWrite *,
+		 CookieClose *)
+{
+  return nullptr;
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////
+
+size_t
+gzipSizeHint(const char *filename)
+{
+  size_t size = 0;
+  FILE *stream = fopen(filename, "rb");
+  if (stream) {
+    unsigned char trailer[4];
+    // ISIZE is the last 4 bytes, little endian.
+    if (fseek(stream, -4, SEEK_END) == 0
+	&& fread(trailer, 1, 4, stream) == 4)
+      size = trailer[0]
+	| (trailer[1] << 8)
+	| (trailer[2] << 16)
+	| (static_cast<size_t>(trailer[3]) << 24);
+    fclose(stream);
+  }
+  return size;
+}
+
+#if ZLIB
+
+////////////////////////////////////////////////////////////////
+
+// Cookie functions so the Si2 parser and the DEF writer use compressed
+// files through a FILE.
+
+static ssize_t
+gzipCookieRead(void *cookie,
+	       char *buffer,
+	       size_t size)
+{
+  gzFile stream = static_cast<gzFile>(cookie);
+  // gzread sizes are unsigned.
+  unsigned read_size = min(size, static_cast<size_t>(1u << 30));
+  return gzread(stream, buffer, read_size);
+}
+
+static int
+gzipCookieReadClose(void *cookie)
+{
+  gzFile stream = static_cast<gzFile>(cookie);
+  return (gzclose(stream) == Z_OK) ? 0 : -1;
+}
+
+FILE *
+openReadStream(const char *filename)
+{
+  if (isCompressedFilename(filename)) {
+    gzFile stream = gzopen(filename, "rb");
+    if (stream == nullptr)
+      return nullptr;
+    // Larger than the default 8K buffer; DEF files are big.
+    gzbuffer(stream, 1 << 17);
+    FILE *file = openCookieStream(stream, "r", gzipCookieRead, nullptr,
+				  gzipCookieReadClose);
+    if (file == nullptr)
+      gzclose(stream);
+    return file;
+  }
+  else
+    return fopen(filename, "r");
+}
+
+////////////////////////////////////////////////////////////////
+
+// Uncompressed bytes per gzip member. Large enough that the member
+// headers and the restarted dictionary cost little compression.
+static const size_t gzip_block_size = 1 << 20;
+
+// Buffer thread_count blocks and compress them concurrently, each as
+// its own gzip member, then write the members in order.
+// The worker threads are started by the first flush with more than one
+// block and run until close.
+class GzipBlockWriter
+{
+public:
+  GzipBlockWriter(FILE *stream,
+		  int compress_level,
+		  int thread_count);
+  ssize_t write(const char *data,
+		size_t size);
+  // Return false if the file could not be written.
+  bool close();
+
+private:
+  bool flush();
+  void startWorkers();
+  void stopWorkers();
+  void worker(int block);
+  void compressBlock(int block);
+  bool compressBlock(const char *data,
+		     size_t size,
+		     // Return value.
+		     Vector<char> &member);
+
+  FILE *stream_;
+  int compress_level_;
+  int thread_count_;
+  Vector<char> buffer_;
+  size_t buffer_size_;
+  Vector<Vector<char>> members_;
+  bool error_;
+  std::atomic<bool> compressed_;
+
+  // Worker i compresses block i; the flushing thread compresses block 0.
+  Vector<std::thread> workers_;
+  std::mutex lock_;
+  // Signalled when a flush has blocks for the workers or they should exit.
+  std::condition_variable work_ready_;
+  // Signalled when the last busy worker finishes its block.
+  std::condition_variable work_done_;
+  // Incremented by each flush that uses the workers.
+  int generation_;
+  int block_count_;
+  int workers_busy_;
+  bool stop_;
+};
+
+GzipBlockWriter::GzipBlockWriter(FILE *stream,
+				 int compress_level,
+				 int thread_count) :
+  stream_(stream),
+  compress_level_(compress_level),
+  thread_count_(max(thread_count, 1)),
+  buffer_(gzip_block_size * thread_count_),
+  buffer_size_(0),
+  members_(thread_count_),
+  error_(false),
+  compressed_(true),
+  generation_(0),
+  block_count_(0),
+  workers_busy_(0),
+  stop_(false)
+{
+}
+
+ssize_t
+GzipBlockWriter::write(const char *data,
+		       size_t size)
+{
+  size_t remaining = size;
+  while (remaining > 0) {
+    size_t copy_size = min(remaining, buffer_.size() - buffer_size_);
+    memcpy(&buffer_[buffer_size_], data, copy_size);
+    buffer_size_ += copy_size;
+    data += copy_size;
+    remaining -= copy_size;
+    if (buffer_size_ == buffer_.size()
+	&& !flush())
+      return -1;
+  }
+  return size;
+}
+
+bool
+GzipBlockWriter::flush()
+{
+  int block_count = (buffer_size_ + gzip_block_size - 1) / gzip_block_size;
+  compressed_ = true;
+  if (block_count <= 1) {
+    for (int block = 0; block < block_count; block++)
+      compressBlock(block);
+  }
+  else {
+    if (workers_.empty())
+      startWorkers();
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      block_count_ = block_count;
+      workers_busy_ = workers_.size();
+      generation_++;
+    }
+    work_ready_.notify_all();
+    compressBlock(0);
+    std::unique_lock<std::mutex> lock(lock_);
+    work_done_.wait(lock, [this] () { return workers_busy_ == 0; });
+  }
+  if (!compressed_)
+    error_ = true;
+  for (int block = 0; block < block_count && !error_; block++) {
+    Vector<char> &member = members_[block];
+    if (fwrite(&member[0], 1, member.size(), stream_) != member.size())
+      error_ = true;
+  }
+  buffer_size_ = 0;
+  return !error_;
+}
+
+void
+GzipBlockWriter::startWorkers()
+{
+  for (int block = 1; block < thread_count_; block++)
+    workers_.push_back(std::thread(&GzipBlockWriter::worker, this, block));
+}
+
+void
+GzipBlockWriter::stopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    stop_ = true;
+  }
+  work_ready_.notify_all();
+  for (auto &worker : workers_)
+    worker.join();
+  workers_.clear();
+}
+
+void
+GzipBlockWriter::worker(int block)
+{
+  int generation = 0;
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true) {
+    work_ready_.wait(lock, [&] () {
+      return stop_ || generation_ != generation;
+    });
+    if (stop_)
+      break;
+    generation = generation_;
+    int block_count = block_count_;
+    lock.unlock();
+    if (block < block_count)
+      compressBlock(block);
+    lock.lock();
+    if (--workers_busy_ == 0)
+      work_done_.notify_one();
+  }
+}
+
+void
+GzipBlockWriter::compressBlock(int block)
+{
+  size_t begin = block * gzip_block_size;
+  size_t size = min(gzip_block_size, buffer_size_ - begin);
+  if (!compressBlock(&buffer_[begin], size, members_[block]))
+    compressed_ = false;
+}
+
+bool
+GzipBlockWriter::compressBlock(const char *data,
+			       size_t size,
+			       // Return value.
+			       Vector<char> &member)
+{
+  z_stream zstream;
+  memset(&zstream, 0, sizeof(zstream));
+  // windowBits 15 + 16 writes a gzip header and trailer.
+  if (deflateInit2(&zstream, compress_level_, Z_DEFLATED, 15 + 16, 8,
+		   Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+  member.resize(deflateBound(&zstream, size));
+  zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  zstream.avail_in = size;
+  zstream.next_out = reinterpret_cast<Bytef*>(&member[0]);
+  zstream.avail_out = member.size();
+  bool finished = (deflate(&zstream, Z_FINISH) == Z_STREAM_END);
+  member.resize(zstream.total_out);
+  deflateEnd(&zstream);
+  return finished;
+}
+
+bool
+GzipBlockWriter::close()
+{
+  if (buffer_size_ > 0)
+    flush();
+  stopWorkers();
+  if (fclose(stream_) != 0)
+    error_ = true;
+  return !error_;
+}
+
+static ssize_t
+gzipCookieWrite(void *cookie,
+		const char *data,
+		size_t size)
+{
+  GzipBlockWriter *writer = static_cast<GzipBlockWriter*>(cookie);
+  return writer->write(data, size);
+}
+
+static int
+gzipCookieWriteClose(void *cookie)
+{
+  GzipBlockWriter *writer = static_cast<GzipBlockWriter*>(cookie);
+  bool written = writer->close();
+  delete writer;
+  return written ? 0 : -1;
+}
+
+FILE *
+openWriteStream(const char *filename,
+		int compress_level,
+		int thread_count)
+{
+  if (isCompressedFilename(filename)) {
+    FILE *stream = fopen(filename, "wb");
+    if (stream == nullptr)
+      return nullptr;
+    compress_level = min(max(compress_level, 1), 9);
+    GzipBlockWriter *writer = new GzipBlockWriter(stream, compress_level,
+						  thread_count);
+    FILE *file = openCookieStream(writer, "w", nullptr, gzipCookieWrite,
+				  gzipCookieWriteClose);
+    if (file == nullptr) {
+      writer->close();
+      delete writer;
+    }
+    return file;
+  }
+  else
+    return fopen(filename, "w");
+}
+
+#else // ZLIB
+
+FILE *
+openReadStream(const char *filename)
+{
+  if (isCompressedFilename(filename))
+    return nullptr;
+  else
+    return fopen(filename, "r");
+}
+
+FILE *
+openWriteStream(const char *filename,
+		int,
+		int)
+{
+  if (isCompressedFilename(filename))
+    return nullptr;
+  else
+    return fopen(filename, "w");
+}
+
+#endif // ZLIB
+
+} // namespace
@@ -0,0 +1,77 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_COMPRESSED_FILE_H
+#define RESIZER_COMPRESSED_FILE_H
+
+#include <cstdio>
+#include <sys/types.h>
+
+namespace sta {
+
+static const int compress_level_default = 6;
+
+// True if filename ends in ".gz".
+bool
+isCompressedFilename(const char *filename);
+
+// Cookie stream functions. Read and write return the byte count, 0 at
+// the end of the input or -1 for an error. Close returns 0 or -1.
+typedef ssize_t (CookieRead)(void *cookie,
+			     char *buffer,
+			     size_t size);
+typedef ssize_t (CookieWrite)(void *cookie,
+			      const char *data,
+			      size_t size);
+typedef int (CookieClose)(void *cookie);
+
+// Open a FILE that reads (mode "r") or writes (mode "w") through the
+// cookie functions, with fopencookie on glibc or funopen on BSD/macOS.
+// Closing the FILE calls close(cookie).
+// Return null if the stream cannot be opened or the platform has
+// neither; the cookie is not closed in that case.
+FILE *
+openCookieStream(void *cookie,
+		 const char *mode,
+		 CookieRead *read,
+		 CookieWrite *write,
+		 CookieClose *close);
+
+// Return the uncompressed size recorded in the gzip trailer of filename,
+// or 0 if it cannot be read. The trailer only covers the last member,
+// so this is exact for single member files under 4GB and only a hint
+// for anything else.
+size_t
+gzipSizeHint(const char *filename);
+
+// Open filename for reading like fopen(filename, "r").
+// Compressed files are decompressed as they are read.
+// Return null if the file cannot be opened. Compressed files cannot be
+// opened if Resizer was built without zlib.
+FILE *
+openReadStream(const char *filename);
+// Open filename for writing like fopen(filename, "w").
+// Compressed files are written as a sequence of gzip members that are
+// compressed at compress_level (1-9) by thread_count threads; gzip and
+// zlib read them as one stream.
+// Return null if the file cannot be opened.
+FILE *
+openWriteStream(const char *filename,
+		int compress_level,
+		int thread_count);
+
+} // namespace
+#endif
@@ -0,0 +1,1241 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <thread>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Debug.hh"
+#include "Error.hh"
+#include "MappedFile.hh"
+#include "CompressedFile.hh"
+#include "PortDirection.hh"
+#include "LefDefNetwork.hh"
+#include "DefReader.hh"
+#include "DefFastReader.hh"
+
+// DEF reader for the subset of DEF used to build the network.
+// Sections that do not make network objects are skipped without
+// tokenizing them.
+
+namespace sta {
+
+using std::min;
+using std::max;
+
+static const size_t def_number_length_max = 63;
+static const size_t def_inflate_chunk_size = 1 << 20;
+
+// Token in the file text. Tokens are not null terminated.
+class DefToken
+{
+public:
+  DefToken();
+  DefToken(const char *str,
+	   size_t length);
+  bool isNull() const { return str_ == nullptr; }
+  bool equal(const char *str) const;
+  string str() const { return string(str_, length_); }
+  // Copy to buffer, reusing its storage, and return the null terminated
+  // text.
+  const char *copy(string &buffer) const;
+  // Return false if the token is not a number.
+  bool number(double &value) const;
+
+  const char *str_;
+  size_t length_;
+};
+
+DefToken::DefToken() :
+  str_(nullptr),
+  length_(0)
+{
+}
+
+DefToken::DefToken(const char *str,
+		   size_t length) :
+  str_(str),
+  length_(length)
+{
+}
+
+const char *
+DefToken::copy(string &buffer) const
+{
+  buffer.assign(str_, length_);
+  return buffer.c_str();
+}
+
+bool
+DefToken::equal(const char *str) const
+{
+  return str_
+    && strncmp(str_, str, length_) == 0
+    && str[length_] == '\0';
+}
+
+// The mapped file text is not null terminated, so the token is copied
+// to a local buffer for strtod. Longer tokens are not numbers.
+bool
+DefToken::number(double &value) const
+{
+  char buffer[def_number_length_max + 1];
+  if (length_ == 0 || length_ > def_number_length_max)
+    return false;
+  memcpy(buffer, str_, length_);
+  buffer[length_] = '\0';
+  char *end;
+  value = strtod(buffer, &end);
+  return end == buffer + length_;
+}
+
+static bool
+isDefSpace(char ch)
+{
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r'
+    || ch == '\f' || ch == '\v';
+}
+
+////////////////////////////////////////////////////////////////
+
+class DefTokenizer
+{
+public:
+  DefTokenizer(const char *begin,
+	       const char *end);
+  // Return false at the end of the text.
+  bool next(DefToken &token);
+  // Return false at the end of the text or if the token is not str.
+  bool expect(const char *str);
+  // Move past the next ch outside a quoted string without tokenizing
+  // the text before it. Return false if there is no ch.
+  bool skipPast(char ch);
+  const char *position() const { return pos_; }
+  void setPosition(const char *pos) { pos_ = pos; }
+
+private:
+  const char *pos_;
+  const char *end_;
+};
+
+DefTokenizer::DefTokenizer(const char *begin,
+			   const char *end) :
+  pos_(begin),
+  end_(end)
+{
+}
+
+bool
+DefTokenizer::next(DefToken &token)
+{
+  while (pos_ < end_) {
+    if (isDefSpace(*pos_))
+      pos_++;
+    else if (*pos_ == '#') {
+      // Comment to the end of the line.
+      const void *eol = memchr(pos_, '\n', end_ - pos_);
+      pos_ = eol ? static_cast<const char*>(eol) + 1 : end_;
+    }
+    else
+      break;
+  }
+  if (pos_ >= end_)
+    return false;
+  if (*pos_ == '"') {
+    const char *begin = pos_ + 1;
+    const void *quote = memchr(begin, '"', end_ - begin);
+    const char *quote_end = quote ? static_cast<const char*>(quote) : end_;
+    token = DefToken(begin, quote_end - begin);
+    pos_ = (quote_end < end_) ? quote_end + 1 : end_;
+  }
+  else {
+    const char *begin = pos_;
+    while (pos_ < end_ && !isDefSpace(*pos_))
+      pos_++;
+    token = DefToken(begin, pos_ - begin);
+  }
+  return true;
+}
+
+bool
+DefTokenizer::expect(const char *str)
+{
+  DefToken token;
+  return next(token)
+    && token.equal(str);
+}
+
+bool
+DefTokenizer::skipPast(char ch)
+{
+  while (pos_ < end_) {
+    const char *found =
+      static_cast<const char*>(memchr(pos_, ch, end_ - pos_));
+    if (found == nullptr)
+      break;
+    const char *quote =
+      static_cast<const char*>(memchr(pos_, '"', found - pos_));
+    if (quote == nullptr) {
+      pos_ = found + 1;
+      return true;
+    }
+    // ch is in or after a quoted string (a PROPERTY value); skip the
+    // string like next.
+    const void *quote_end = memchr(quote + 1, '"', end_ - (quote + 1));
+    if (quote_end == nullptr)
+      break;
+    pos_ = static_cast<const char*>(quote_end) + 1;
+  }
+  pos_ = end_;
+  return false;
+}
+
+////////////////////////////////////////////////////////////////
+
+class DefFastPin
+{
+public:
+  DefToken name_;
+  // DIRECTION or null.
+  DefToken dir_;
+  bool tristate_;
+  // USE or null.
+  DefToken use_;
+  bool placed_;
+  DefPt location_;
+};
+
+class DefFastComponent
+{
+public:
+  DefToken name_;
+  DefToken macro_;
+  int status_;
+  DefPt location_;
+  int orient_;
+  // Index in DefFastChunk::extras_ or -1.
+  int extra_index_;
+};
+
+class DefFastConnection
+{
+public:
+  DefToken inst_;
+  DefToken pin_;
+};
+
+class DefFastNet
+{
+public:
+  DefToken name_;
+  // Range of DefFastChunk::connections_.
+  size_t connection_begin_;
+  size_t connection_end_;
+};
+
+// Records read from one chunk of the COMPONENTS or NETS section.
+class DefFastChunk
+{
+public:
+  DefFastChunk(const char *begin,
+	       const char *end,
+	       bool is_nets,
+	       size_t record_estimate);
+
+  const char *begin_;
+  const char *end_;
+  bool is_nets_;
+  // Share of the section record count, to size the record vectors.
+  size_t record_estimate_;
+  bool error_;
+  Vector<DefFastComponent> components_;
+  Vector<DefComponentExtra> extras_;
+  Vector<DefFastNet> nets_;
+  Vector<DefFastConnection> connections_;
+};
+
+DefFastChunk::DefFastChunk(const char *begin,
+			   const char *end,
+			   bool is_nets,
+			   size_t record_estimate) :
+  begin_(begin),
+  end_(end),
+  is_nets_(is_nets),
+  record_estimate_(record_estimate),
+  error_(false)
+{
+}
+
+// Statements that change the network, in file order.
+class DefFastStep
+{
+public:
+  enum class Type { design, divider, bus_bit_chars, units, die_area,
+		    pins, components, nets };
+
+  Type type_;
+  // Pin or chunk index range for pins, components and nets.
+  size_t begin_;
+  size_t end_;
+  // Record count from the section header.
+  int count_;
+};
+
+class DefFastReader
+{
+public:
+  DefFastReader(const char *filename,
+		bool save_def_data,
+		bool skip_routing,
+		int thread_count,
+		LefDefNetwork *network);
+  ~DefFastReader();
+  bool read();
+
+private:
+  void readText();
+  bool scan();
+  bool skipStatement(DefTokenizer &tokenizer);
+  bool skipSection(DefTokenizer &tokenizer,
+		   const char *section);
+  bool readSectionCount(DefTokenizer &tokenizer,
+			// Return value.
+			int &count);
+  bool readPins(DefTokenizer &tokenizer);
+  bool readPin(DefTokenizer &tokenizer);
+  bool splitSection(DefTokenizer &tokenizer,
+		    const char *section,
+		    bool is_nets,
+		    int count);
+  void readChunks();
+  bool readChunk(DefFastChunk &chunk);
+  bool readComponent(DefTokenizer &tokenizer,
+		     DefFastChunk &chunk);
+  bool readComponentOption(DefToken &option,
+			   DefTokenizer &tokenizer,
+			   DefFastComponent &component,
+			   DefComponentExtra &extra,
+			   bool &has_extra);
+  bool readNet(DefTokenizer &tokenizer,
+	       DefFastChunk &chunk);
+  bool designFirst() const;
+  void addStep(DefFastStep::Type type,
+	       size_t begin,
+	       size_t end,
+	       int count = 0);
+  void makeNetwork();
+  void makePins(size_t begin,
+		size_t end);
+  void makeComponents(const DefFastChunk &chunk);
+  void makeNets(const DefFastChunk &chunk);
+
+  const char *filename_;
+  bool save_def_data_;
+  bool skip_routing_;
+  int thread_count_;
+  LefDefNetwork *network_;
+  // Tokens point into the file text until the network objects are made
+  // from them. Compressed files are decompressed into inflated_ because
+  // they cannot be mapped. It is malloc'd so it grows with realloc
+  // instead of copying and zero filling.
+  std::unique_ptr<MappedFile> mapped_;
+  char *inflated_;
+  const char *text_;
+  const char *text_end_;
+
+  DefToken design_;
+  DefToken divider_;
+  DefToken bus_bit_chars_;
+  double units_;
+  DefDbu die_lx_;
+  DefDbu die_ly_;
+  DefDbu die_ux_;
+  DefDbu die_uy_;
+  Vector<DefFastPin> pins_;
+  Vector<DefFastChunk> chunks_;
+  Vector<DefFastStep> steps_;
+};
+
+bool
+readDefFast(const char *filename,
+	    bool save_def_data,
+	    const DefSkip &skip,
+	    int thread_count,
+	    LefDefNetwork *network)
+{
+  DefFastReader reader(filename, save_def_data, skip.routing_, thread_count,
+		       network);
+  return reader.read();
+}
+
+DefFastReader::DefFastReader(const char *filename,
+			     bool save_def_data,
+			     bool skip_routing,
+			     int thread_count,
+			     LefDefNetwork *network) :
+  filename_(filename),
+  save_def_data_(save_def_data),
+  skip_routing_(skip_routing),
+  thread_count_(max(thread_count, 1)),
+  network_(network),
+  inflated_(nullptr),
+  text_(nullptr),
+  text_end_(nullptr),
+  units_(0.0),
+  die_lx_(0),
+  die_ly_(0),
+  die_ux_(0),
+  die_uy_(0)
+{
+}
+
+DefFastReader::~DefFastReader()
+{
+  free(inflated_);
+}
+
+bool
+DefFastReader::read()
+{
+  readText();
+  if (!scan())
+    return false;
+  readChunks();
+  for (const DefFastChunk &chunk : chunks_) {
+    if (chunk.error_) {
+      debugPrint1(network_->debug(), "def_reader", 1,
+		  "unsupported %s record\n",
+		  chunk.is_nets_ ? "NETS" : "COMPONENTS");
+      return false;
+    }
+  }
+  makeNetwork();
+  return true;
+}
+
+void
+DefFastReader::readText()
+{
+  if (isCompressedFilename(filename_)) {
+    FILE *stream = openReadStream(filename_);
+    if (stream == nullptr)
+      throw FileNotReadable(filename_);
+    // Start with the size from the gzip trailer so a single member file
+    // is inflated without growing the buffer. The extra byte lets fread
+    // see the end of the file without a resize.
+    size_t capacity = max(gzipSizeHint(filename_) + 1, def_inflate_chunk_size);
+    inflated_ = static_cast<char*>(malloc(capacity));
+    if (inflated_ == nullptr) {
+      fclose(stream);
+      throw std::bad_alloc();
+    }
+    size_t size = 0;
+    size_t read_size;
+    do {
+      if (size == capacity) {
+	capacity += max(capacity / 2, def_inflate_chunk_size);
+	char *inflated = static_cast<char*>(realloc(inflated_, capacity));
+	if (inflated == nullptr) {
+	  fclose(stream);
+	  throw std::bad_alloc();
+	}
+	inflated_ = inflated;
+      }
+      read_size = fread(inflated_ + size, 1,
+			min(capacity - size, def_inflate_chunk_size), stream);
+      size += read_size;
+    } while (read_size > 0);
+    bool read_error = ferror(stream) != 0;
+    fclose(stream);
+    if (read_error)
+      throw FileNotReadable(filename_);
+    text_ = inflated_;
+    text_end_ = text_ + size;
+  }
+  else {
+    mapped_.reset(new MappedFile(filename_));
+    text_ = mapped_->data();
+    text_end_ = mapped_->end();
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+// Serial pass over the top level statements. The PINS section is read
+// here because it is small; the COMPONENTS and NETS sections are only
+// split into chunks.
+bool
+DefFastReader::scan()
+{
+  DefTokenizer tokenizer(text_, text_end_);
+  DefToken keyword;
+  while (tokenizer.next(keyword)) {
+    bool ok = true;
+    if (keyword.equal("VERSION")
+	|| keyword.equal("NAMESCASESENSITIVE")
+	|| keyword.equal("TECHNOLOGY")
+	|| keyword.equal("HISTORY")
+	|| keyword.equal("ROW")
+	|| keyword.equal("TRACKS")
+	|| keyword.equal("GCELLGRID")
+	|| keyword.equal("COMPONENTMASKSHIFT"))
+      ok = skipStatement(tokenizer);
+    else if (keyword.equal("DESIGN")) {
+      ok = tokenizer.next(design_)
+	&& tokenizer.expect(";");
+      addStep(DefFastStep::Type::design, 0, 0);
+    }
+    else if (keyword.equal("DIVIDERCHAR")) {
+      ok = tokenizer.next(divider_)
+	&& divider_.length_ >= 1
+	&& tokenizer.expect(";");
+      addStep(DefFastStep::Type::divider, 0, 0);
+    }
+    else if (keyword.equal("BUSBITCHARS")) {
+      ok = tokenizer.next(bus_bit_chars_)
+	&& bus_bit_chars_.length_ >= 2
+	&& tokenizer.expect(";");
+      addStep(DefFastStep::Type::bus_bit_chars, 0, 0);
+    }
+    else if (keyword.equal("UNITS")) {
+      DefToken units;
+      ok = tokenizer.expect("DISTANCE")
+	&& tokenizer.expect("MICRONS")
+	&& tokenizer.next(units)
+	&& units.number(units_)
+	&& tokenizer.expect(";");
+      addStep(DefFastStep::Type::units, 0, 0);
+    }
+    else if (keyword.equal("DIEAREA")) {
+      // Polygon die areas are not used, like the Si2 reader callback.
+      Vector<DefPt> points;
+      DefToken token;
+      while (ok && tokenizer.next(token) && token.equal("(")) {
+	DefToken x, y;
+	double x_value, y_value;
+	ok = tokenizer.next(x) && x.number(x_value)
+	  && tokenizer.next(y) && y.number(y_value)
+	  && tokenizer.expect(")");
+	points.push_back(DefPt(static_cast<DefDbu>(x_value),
+			       static_cast<DefDbu>(y_value)));
+      }
+      ok = ok && token.equal(";");
+      if (ok && points.size() == 2) {
+	die_lx_ = points[0].x();
+	die_ly_ = points[0].y();
+	die_ux_ = points[1].x();
+	die_uy_ = points[1].y();
+	addStep(DefFastStep::Type::die_area, 0, 0);
+      }
+    }
+    else if (keyword.equal("PROPERTYDEFINITIONS")
+	     || keyword.equal("VIAS")
+	     || keyword.equal("STYLES")
+	     || keyword.equal("NONDEFAULTRULES")
+	     || keyword.equal("REGIONS")
+	     || keyword.equal("PINPROPERTIES")
+	     || keyword.equal("BLOCKAGES")
+	     || keyword.equal("SLOTS")
+	     || keyword.equal("FILLS")
+	     || keyword.equal("SPECIALNETS")
+	     || keyword.equal("SCANCHAINS")
+	     || keyword.equal("GROUPS")) {
+      string section = keyword.str();
+      ok = skipSection(tokenizer, section.c_str());
+    }
+    else if (keyword.equal("PINS")) {
+      size_t begin = pins_.size();
+      int count;
+      ok = readSectionCount(tokenizer, count);
+      if (ok)
+	pins_.reserve(begin + count);
+      ok = ok && readPins(tokenizer);
+      addStep(DefFastStep::Type::pins, begin, pins_.size(), count);
+    }
+    else if (keyword.equal("COMPONENTS")) {
+      size_t begin = chunks_.size();
+      int count;
+      ok = readSectionCount(tokenizer, count)
+	&& splitSection(tokenizer, "COMPONENTS", false, count);
+      addStep(DefFastStep::Type::components, begin, chunks_.size(), count);
+    }
+    else if (keyword.equal("NETS")) {
+      size_t begin = chunks_.size();
+      int count;
+      ok = readSectionCount(tokenizer, count)
+	&& splitSection(tokenizer, "NETS", true, count);
+      addStep(DefFastStep::Type::nets, begin, chunks_.size(), count);
+    }
+    else if (keyword.equal("END"))
+      return tokenizer.expect("DESIGN")
+	&& designFirst();
+    else
+      ok = false;
+
+    if (!ok) {
+      string keyword_str = keyword.str();
+      debugPrint1(network_->debug(), "def_reader", 1,
+		  "unsupported DEF statement %s\n",
+		  keyword_str.c_str());
+      return false;
+    }
+  }
+  return false;
+}
+
+// The top instance has to be made before the sections that use it.
+bool
+DefFastReader::designFirst() const
+{
+  for (const DefFastStep &step : steps_) {
+    switch (step.type_) {
+    case DefFastStep::Type::design:
+      return true;
+    case DefFastStep::Type::pins:
+    case DefFastStep::Type::components:
+    case DefFastStep::Type::nets:
+      return false;
+    default:
+      break;
+    }
+  }
+  return false;
+}
+
+void
+DefFastReader::addStep(DefFastStep::Type type,
+		       size_t begin,
+		       size_t end,
+		       int count)
+{
+  steps_.push_back(DefFastStep{type, begin, end, count});
+}
+
+bool
+DefFastReader::skipStatement(DefTokenizer &tokenizer)
+{
+  DefToken token;
+  while (tokenizer.next(token)) {
+    if (token.equal(";"))
+      return true;
+  }
+  return false;
+}
+
+bool
+DefFastReader::readSectionCount(DefTokenizer &tokenizer,
+				// Return value.
+				int &count)
+{
+  DefToken count_token;
+  double count_value;
+  count = 0;
+  if (tokenizer.next(count_token)
+      && count_token.number(count_value)
+      && tokenizer.expect(";")) {
+    // The count is only used to size tables, so a wrong count is not
+    // an error.
+    count = max(static_cast<int>(count_value), 0);
+    return true;
+  }
+  else
+    return false;
+}
+
+// Find the "END section" line after pos.
+// Return the start of the line and the position after the section name.
+static bool
+findSectionEnd(const char *pos,
+	       const char *end,
+	       const char *section,
+	       // Return values.
+	       const char *&end_line,
+	       const char *&end_after)
+{
+  size_t section_length = strlen(section);
+  const char *line = pos;
+  while (line < end) {
+    const char *p = line;
+    while (p < end && (*p == ' ' || *p == '\t'))
+      p++;
+    if (end - p > 3
+	&& strncmp(p, "END", 3) == 0
+	&& isDefSpace(p[3])) {
+      const char *q = p + 3;
+      while (q < end && (*q == ' ' || *q == '\t'))
+	q++;
+      if (static_cast<size_t>(end - q) >= section_length
+	  && strncmp(q, section, section_length) == 0
+	  && (q + section_length == end || isDefSpace(q[section_length]))) {
+	end_line = line;
+	end_after = q + section_length;
+	return true;
+      }
+    }
+    const void *eol = memchr(p, '\n', end - p);
+    if (eol == nullptr)
+      break;
+    line = static_cast<const char*>(eol) + 1;
+  }
+  return false;
+}
+
+bool
+DefFastReader::skipSection(DefTokenizer &tokenizer,
+			   const char *section)
+{
+  const char *end_line, *end_after;
+  if (findSectionEnd(tokenizer.position(), text_end_, section,
+		     end_line, end_after)) {
+    tokenizer.setPosition(end_after);
+    return true;
+  }
+  else
+    return false;
+}
+
+////////////////////////////////////////////////////////////////
+
+bool
+DefFastReader::readPins(DefTokenizer &tokenizer)
+{
+  DefToken token;
+  while (tokenizer.next(token)) {
+    if (token.equal("-")) {
+      if (!readPin(tokenizer))
+	return false;
+    }
+    else if (token.equal("END"))
+      return tokenizer.expect("PINS");
+    else
+      return false;
+  }
+  return false;
+}
+
+bool
+DefFastReader::readPin(DefTokenizer &tokenizer)
+{
+  DefFastPin pin;
+  pin.tristate_ = false;
+  pin.placed_ = false;
+  DefToken token;
+  if (!tokenizer.next(pin.name_)
+      || !tokenizer.next(token))
+    return false;
+  while (!token.equal(";")) {
+    if (token.equal("+")) {
+      DefToken option;
+      if (!tokenizer.next(option))
+	return false;
+      if (option.equal("DIRECTION")) {
+	if (!tokenizer.next(pin.dir_))
+	  return false;
+	if (pin.dir_.equal("OUTPUT")) {
+	  const char *pos = tokenizer.position();
+	  DefToken tristate;
+	  if (tokenizer.next(tristate)
+	      && tristate.equal("TRISTATE"))
+	    pin.tristate_ = true;
+	  else
+	    tokenizer.setPosition(pos);
+	}
+      }
+      else if (option.equal("USE")) {
+	if (!tokenizer.next(pin.use_))
+	  return false;
+      }
+      else if (option.equal("PLACED")
+	       || option.equal("FIXED")
+	       || option.equal("COVER")) {
+	DefToken x, y;
+	double x_value, y_value;
+	if (!(tokenizer.expect("(")
+	      && tokenizer.next(x) && x.number(x_value)
+	      && tokenizer.next(y) && y.number(y_value)
+	      && tokenizer.expect(")")))
+	  return false;
+	pin.placed_ = true;
+	pin.location_ = DefPt(static_cast<DefDbu>(x_value),
+			      static_cast<DefDbu>(y_value));
+      }
+      else if (option.equal("PORT"))
+	// Pins with multiple ports are left to the Si2 reader.
+	return false;
+    }
+    // Arguments of options that are not used are skipped.
+    if (!tokenizer.next(token))
+      return false;
+  }
+  pins_.push_back(pin);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Chunks are at least this large so small designs are not split.
+static const size_t def_chunk_size_min = 1 << 20;
+
+// Return the start of the first record that starts on a line after pos.
+// Records start with "- " at the beginning of a line. Negative numbers
+// in routing never have a space after the minus sign.
+static const char *
+findRecordStart(const char *pos,
+		const char *end)
+{
+  const void *eol = memchr(pos, '\n', end - pos);
+  while (eol) {
+    const char *p = static_cast<const char*>(eol) + 1;
+    while (p < end && (*p == ' ' || *p == '\t'))
+      p++;
+    if (end - p > 1
+	&& p[0] == '-'
+	&& isDefSpace(p[1]))
+      return p;
+    eol = memchr(p, '\n', end - p);
+  }
+  return end;
+}
+
+bool
+DefFastReader::splitSection(DefTokenizer &tokenizer,
+			    const char *section,
+			    bool is_nets,
+			    int count)
+{
+  const char *begin = tokenizer.position();
+  const char *end_line, *end_after;
+  if (!findSectionEnd(begin, text_end_, section, end_line, end_after))
+    return false;
+  tokenizer.setPosition(end_after);
+  size_t size = end_line - begin;
+  // Several chunks per thread to even out the record sizes.
+  size_t chunk_size = max(size / (thread_count_ * 4), def_chunk_size_min);
+  const char *chunk_begin = begin;
+  while (chunk_begin < end_line) {
+    const char *chunk_end = end_line;
+    if (static_cast<size_t>(end_line - chunk_begin) > chunk_size)
+      chunk_end = findRecordStart(chunk_begin + chunk_size, end_line);
+    // Records in the chunk if they are all the same size.
+    size_t record_estimate = size
+      ? count * static_cast<size_t>(chunk_end - chunk_begin) / size
+      : 0;
+    chunks_.push_back(DefFastChunk(chunk_begin, chunk_end, is_nets,
+				   record_estimate));
+    chunk_begin = chunk_end;
+  }
+  return true;
+}
+
+// The chunks are handed to the threads as they finish the previous one.
+void
+DefFastReader::readChunks()
+{
+  int chunk_count = chunks_.size();
+  int thread_count = min(thread_count_, chunk_count);
+  if (thread_count <= 1) {
+    for (auto &chunk : chunks_)
+      chunk.error_ = !readChunk(chunk);
+  }
+  else {
+    std::atomic<int> next_chunk(0);
+    Vector<std::thread> threads;
+    for (int i = 0; i < thread_count; i++) {
+      threads.push_back(std::thread([&] () {
+	    for (int index = next_chunk++; index < chunk_count; index = next_chunk++) {
+	      DefFastChunk &chunk = chunks_[index];
+	      chunk.error_ = !readChunk(chunk);
+	    }
+	  }));
+    }
+    for (auto &thread : threads)
+      thread.join();
+  }
+}
+
+bool
+DefFastReader::readChunk(DefFastChunk &chunk)
+{
+  if (chunk.is_nets_)
+    chunk.nets_.reserve(chunk.record_estimate_);
+  else
+    chunk.components_.reserve(chunk.record_estimate_);
+  DefTokenizer tokenizer(chunk.begin_, chunk.end_);
+  DefToken token;
+  while (tokenizer.next(token)) {
+    if (!token.equal("-"))
+      return false;
+    bool ok = chunk.is_nets_
+      ? readNet(tokenizer, chunk)
+      : readComponent(tokenizer, chunk);
+    if (!ok)
+      return false;
+  }
+  return true;
+}
+
+static bool
+readDefPoint(DefTokenizer &tokenizer,
+	     // Return value.
+	     DefPt &point)
+{
+  DefToken x, y;
+  double x_value, y_value;
+  if (tokenizer.expect("(")
+      && tokenizer.next(x) && x.number(x_value)
+      && tokenizer.next(y) && y.number(y_value)
+      && tokenizer.expect(")")) {
+    point = DefPt(static_cast<DefDbu>(x_value),
+		  static_cast<DefDbu>(y_value));
+    return true;
+  }
+  else
+    return false;
+}
+
+static const char *def_orients[] = {"N", "W", "S", "E",
+				    "FN", "FW", "FS", "FE"};
+
+// Return false for orientations other than N..FE.
+static bool
+readDefOrient(DefTokenizer &tokenizer,
+	      // Return value.
+	      int &orient)
+{
+  DefToken token;
+  if (tokenizer.next(token)) {
+    for (int i = 0; i < 8; i++) {
+      if (token.equal(def_orients[i])) {
+	orient = i;
+	return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool
+DefFastReader::readComponent(DefTokenizer &tokenizer,
+			     DefFastChunk &chunk)
+{
+  DefFastComponent component;
+  component.status_ = 0;
+  component.orient_ = 0;
+  component.extra_index_ = -1;
+  DefComponentExtra extra;
+  bool has_extra = false;
+  DefToken token;
+  if (!tokenizer.next(component.name_)
+      || !tokenizer.next(component.macro_)
+      || !tokenizer.next(token))
+    return false;
+  while (!token.equal(";")) {
+    if (token.equal("+")) {
+      DefToken option;
+      if (!tokenizer.next(option)
+	  || !readComponentOption(option, tokenizer, component,
+				  extra, has_extra))
+	return false;
+    }
+    // Arguments of options that are not used are skipped.
+    if (!tokenizer.next(token))
+      return false;
+  }
+  if (has_extra && save_def_data_) {
+    component.extra_index_ = chunk.extras_.size();
+    chunk.extras_.push_back(extra);
+  }
+  chunk.components_.push_back(component);
+  return true;
+}
+
+bool
+DefFastReader::readComponentOption(DefToken &option,
+				   DefTokenizer &tokenizer,
+				   DefFastComponent &component,
+				   DefComponentExtra &extra,
+				   bool &has_extra)
+{
+  if (option.equal("PLACED")
+      || option.equal("FIXED")
+      || option.equal("COVER")) {
+    if (option.equal("PLACED"))
+      component.status_ = DEFI_COMPONENT_PLACED;
+    else if (option.equal("FIXED"))
+      component.status_ = DEFI_COMPONENT_FIXED;
+    else
+      component.status_ = DEFI_COMPONENT_COVER;
+    return readDefPoint(tokenizer, component.location_)
+      && readDefOrient(tokenizer, component.orient_);
+  }
+  else if (option.equal("UNPLACED")) {
+    component.status_ = DEFI_COMPONENT_UNPLACED;
+    return true;
+  }
+  else if (option.equal("EEQMASTER")) {
+    DefToken eeq;
+    has_extra = true;
+    bool ok = tokenizer.next(eeq);
+    extra.eeq_ = eeq.str();
+    return ok;
+  }
+  else if (option.equal("GENERATE")) {
+    DefToken name, macro;
+    has_extra = true;
+    if (!tokenizer.next(name))
+      return false;
+    extra.generate_name_ = name.str();
+    const char *pos = tokenizer.position();
+    if (tokenizer.next(macro)
+	&& !macro.equal("+")
+	&& !macro.equal(";"))
+      extra.generate_macro_ = macro.str();
+    else
+      tokenizer.setPosition(pos);
+    return true;
+  }
+  else if (option.equal("SOURCE")) {
+    DefToken source;
+    has_extra = true;
+    bool ok = tokenizer.next(source);
+    extra.source_ = source.str();
+    return ok;
+  }
+  else if (option.equal("FOREIGN")) {
+    DefToken name, orient;
+    DefPt point;
+    has_extra = true;
+    if (!(tokenizer.next(name)
+	  && readDefPoint(tokenizer, point)
+	  && tokenizer.next(orient)))
+      return false;
+    extra.has_foreign_ = true;
+    extra.foreign_name_ = name.str();
+    extra.foreign_x_ = point.x();
+    extra.foreign_y_ = point.y();
+    extra.foreign_orient_ = orient.str();
+    return true;
+  }
+  else if (option.equal("WEIGHT")) {
+    DefToken weight;
+    double weight_value;
+    has_extra = true;
+    if (!(tokenizer.next(weight)
+	  && weight.number(weight_value)))
+      return false;
+    extra.has_weight_ = true;
+    extra.weight_ = static_cast<int>(weight_value);
+    return true;
+  }
+  else if (option.equal("REGION")) {
+    has_extra = true;
+    const char *pos = tokenizer.position();
+    DefToken region;
+    if (!tokenizer.next(region))
+      return false;
+    if (region.equal("(")) {
+      DefPt ll, ur;
+      tokenizer.setPosition(pos);
+      if (!(readDefPoint(tokenizer, ll)
+	    && readDefPoint(tokenizer, ur)))
+	return false;
+      extra.has_region_bounds_ = true;
+      extra.region_lx_ = ll.x();
+      extra.region_ly_ = ll.y();
+      extra.region_ux_ = ur.x();
+      extra.region_uy_ = ur.y();
+    }
+    else
+      extra.region_name_ = region.str();
+    return true;
+  }
+  else
+    // HALO, ROUTEHALO, MASKSHIFT and PROPERTY are not used.
+    return true;
+}
+
+bool
+DefFastReader::readNet(DefTokenizer &tokenizer,
+		       DefFastChunk &chunk)
+{
+  DefFastNet net;
+  if (!tokenizer.next(net.name_)
+      // MUSTJOIN nets are left to the Si2 reader.
+      || net.name_.equal("MUSTJOIN"))
+    return false;
+  net.connection_begin_ = chunk.connections_.size();
+  DefToken token;
+  if (!tokenizer.next(token))
+    return false;
+  while (token.equal("(")) {
+    DefFastConnection connection;
+    if (!(tokenizer.next(connection.inst_)
+	  && tokenizer.next(connection.pin_)
+	  && tokenizer.next(token)))
+      return false;
+    if (token.equal("+")) {
+      if (!(tokenizer.expect("SYNTHESIZED")
+	    && tokenizer.next(token)))
+	return false;
+    }
+    if (!token.equal(")"))
+      return false;
+    chunk.connections_.push_back(connection);
+    if (!tokenizer.next(token))
+      return false;
+  }
+  net.connection_end_ = chunk.connections_.size();
+  // Routing and other net options are skipped.
+  if (skip_routing_) {
+    if (!token.equal(";")
+	&& !tokenizer.skipPast(';'))
+      return false;
+  }
+  else {
+    while (!token.equal(";")) {
+      if (!tokenizer.next(token))
+	return false;
+    }
+  }
+  chunk.nets_.push_back(net);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Make the network objects in the same order as the Si2 reader
+// callbacks.
+void
+DefFastReader::makeNetwork()
+{
+  for (const DefFastStep &step : steps_) {
+    switch (step.type_) {
+    case DefFastStep::Type::design: {
+      string design = design_.str();
+      Library *lef_library = network_->lefLibrary();
+      Cell *top_cell = network_->makeCell(lef_library, design.c_str(), false,
+					  network_->defFilename());
+      Instance *top_instance = network_->makeInstance(top_cell, "", nullptr);
+      network_->setTopInstance(top_instance);
+      break;
+    }
+    case DefFastStep::Type::divider:
+      network_->setDivider(divider_.str_[0]);
+      break;
+    case DefFastStep::Type::bus_bit_chars: {
+      Library *lef_lib = network_->lefLibrary();
+      ConcreteLibrary *lef_clib = reinterpret_cast<ConcreteLibrary*>(lef_lib);
+      lef_clib->setBusBrkts(bus_bit_chars_.str_[0], bus_bit_chars_.str_[1]);
+      break;
+    }
+    case DefFastStep::Type::units:
+      network_->setDefUnits(static_cast<int>(units_));
+      break;
+    case DefFastStep::Type::die_area:
+      network_->setDieArea(die_lx_, die_ly_, die_ux_, die_uy_);
+      break;
+    case DefFastStep::Type::pins:
+      makePins(step.begin_, step.end_);
+      break;
+    case DefFastStep::Type::components:
+      network_->reserveDefComponents(step.count_);
+      for (size_t i = step.begin_; i < step.end_; i++)
+	makeComponents(chunks_[i]);
+      break;
+    case DefFastStep::Type::nets:
+      for (size_t i = step.begin_; i < step.end_; i++)
+	makeNets(chunks_[i]);
+      break;
+    }
+  }
+}
+
+void
+DefFastReader::makePins(size_t begin,
+			size_t end)
+{
+  Cell *top_cell = network_->cell(network_->topInstance());
+  for (size_t i = begin; i < end; i++) {
+    const DefFastPin &pin = pins_[i];
+    string name = pin.name_.str();
+    Port *port = network_->makePort(top_cell, name.c_str());
+    string dir = pin.tristate_ ? string("OUTPUT TRISTATE") : pin.dir_.str();
+    string use = pin.use_.str();
+    network_->setDirection(port,
+			   defPinDirection(pin.dir_.isNull() ? nullptr : dir.c_str(),
+					   pin.use_.isNull() ? nullptr : use.c_str()));
+    if (pin.placed_)
+      network_->setLocation(port, pin.location_);
+  }
+  // END PINS
+  network_->initTopInstancePins();
+  network_->groupBusPorts(top_cell);
+}
+
+void
+DefFastReader::makeComponents(const DefFastChunk &chunk)
+{
+  Library *lef_lib = network_->lefLibrary();
+  Instance *top_inst = network_->topInstance();
+  Report *report = network_->report();
+  // Names are copied out of the mapped file into reused buffers; the
+  // network makes the only lasting copy.
+  string name_buffer, macro_buffer;
+  for (const DefFastComponent &component : chunk.components_) {
+    const char *name = component.name_.copy(name_buffer);
+    const char *macro = component.macro_.copy(macro_buffer);
+    Cell *cell = network_->findCell(lef_lib, macro);
+    if (cell) {
+      Instance *inst = network_->makeInstance(cell, name, top_inst);
+      if (save_def_data_) {
+	network_->setPlacement(inst, component.location_, component.orient_,
+			       component.status_);
+	if (component.extra_index_ >= 0)
+	  network_->setComponentExtra(inst,
+				      chunk.extras_[component.extra_index_]);
+      }
+    }
+    else
+      report->printError("Error: component %s macro %s not found.\n",
+			 name,
+			 macro);
+  }
+}
+
+void
+DefFastReader::makeNets(const DefFastChunk &chunk)
+{
+  Instance *top_inst = network_->topInstance();
+  string net_buffer, inst_buffer, pin_buffer;
+  for (const DefFastNet &def_net : chunk.nets_) {
+    const char *net_name = def_net.name_.copy(net_buffer);
+    Net *net = network_->makeNet(net_name, top_inst);
+    for (size_t i = def_net.connection_begin_; i < def_net.connection_end_; i++) {
+      const DefFastConnection &connection = chunk.connections_[i];
+      const char *inst_name = connection.inst_.copy(inst_buffer);
+      const char *pin_name = connection.pin_.copy(pin_buffer);
+      defConnectNet(net, net_name, inst_name, pin_name, network_);
+    }
+  }
+}
+
+} // namespace
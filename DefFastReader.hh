@@ -0,0 +1,43 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_DEF_FAST_READER_H
+#define RESIZER_DEF_FAST_READER_H
+
+namespace sta {
+
+class LefDefNetwork;
+class DefSkip;
+
+// Read a DEF file without the Si2 parser. The file is memory mapped (or
+// decompressed into memory if it ends in ".gz") and tokens point into
+// the text; names are copied only when network objects are made from
+// them. The file is scanned once for its sections and the COMPONENTS
+// and NETS records are tokenized in chunks by thread_count threads.
+// The network objects are made in file order afterwards, so the network
+// matches the one made by the Si2 reader. Return false without changing
+// the network if the file uses DEF constructs this reader does not
+// handle. SPECIALNETS, FILLS and BLOCKAGES are never parsed; skipped
+// NETS routing is passed over without tokenizing it.
+bool
+readDefFast(const char *filename,
+	    bool save_def_data,
+	    const DefSkip &skip,
+	    int thread_count,
+	    LefDefNetwork *network);
+
+} // namespace
+#endif
@@ -14,18 +14,30 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 #include "Machine.hh"
 #include "Report.hh"
+#include "Debug.hh"
 #include "Error.hh"
 #include "PortDirection.hh"
 #include "ParseBus.hh"
 #include "LefDefNetwork.hh"
+#include "DefShard.hh"
+#include "CompressedFile.hh"
+#include "DefFastReader.hh"
+#include "DefReader.hh"
 #include "defrReader.hpp"
 
 // Use Cadence DEF parser to build ConcreteNetwork based objects.
 
 namespace sta {
 
+using std::min;
+
 static void
 registerDefCallbacks();
 static int
@@ -49,6 +61,10 @@ defDieAreaCbk(defrCallbackType_e,
 	      defiBox *box,
 	      defiUserData user);
 static int
+defComponentStartCbk(defrCallbackType_e,
+		     int count,
+		     defiUserData user);
+static int
 defComponentCbk(defrCallbackType_e,
 		defiComponent *def_component,
 		defiUserData user);
@@ -67,6 +83,14 @@ defPinEndCbk(defrCallbackType_e,
 static const char *
 defToSta(const char *token,
 	 Network *network);
+static int
+defShardComponentCbk(defrCallbackType_e,
+		     defiComponent *def_component,
+		     defiUserData user);
+static int
+defShardNetCbk(defrCallbackType_e,
+	       defiNet *def_net,
+	       defiUserData user);
 
 ////////////////////////////////////////////////////////////////
 
@@ -84,9 +108,274 @@ private:
   LefDefNetwork *network_;
 };
 
+DefSkip::DefSkip() :
+  routing_(false),
+  special_nets_(false),
+  fills_(false),
+  blockages_(false)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
+// Filter for the stream read by the Si2 parser that drops the skipped
+// content line by line so the parser never tokenizes it.
+class DefSkipFilter
+{
+public:
+  DefSkipFilter(FILE *stream,
+		const DefSkip &skip);
+  ~DefSkipFilter();
+  FILE *stream() const { return stream_; }
+  ssize_t read(char *buffer,
+	       size_t size);
+
+private:
+  void filterLine(const char *line);
+  void filterNetsText(const char *text);
+  const char *routingEnd(const char *text);
+
+  FILE *stream_;
+  DefSkip skip_;
+  char *line_;
+  size_t line_size_;
+  // Filtered text not yet read.
+  string text_;
+  size_t text_pos_;
+  // Name of the section being dropped or null.
+  const char *skip_section_;
+  bool in_nets_;
+  bool in_routing_;
+  // In a quoted string of the routing being dropped.
+  bool in_quote_;
+};
+
+static ssize_t
+defSkipFilterRead(void *cookie,
+		  char *buffer,
+		  size_t size);
+static int
+defSkipFilterClose(void *cookie);
+
+// Return a stream of stream without the skipped content. The returned
+// stream closes stream. Skipping only saves parsing, so stream is
+// returned unfiltered if the platform has no cookie streams.
+static FILE *
+openDefSkipStream(FILE *stream,
+		  const DefSkip &skip)
+{
+  DefSkipFilter *filter = new DefSkipFilter(stream, skip);
+  FILE *filtered = openCookieStream(filter, "r", defSkipFilterRead, nullptr,
+				    defSkipFilterClose);
+  if (filtered == nullptr) {
+    delete filter;
+    return stream;
+  }
+  return filtered;
+}
+
+static ssize_t
+defSkipFilterRead(void *cookie,
+		  char *buffer,
+		  size_t size)
+{
+  DefSkipFilter *filter = static_cast<DefSkipFilter*>(cookie);
+  return filter->read(buffer, size);
+}
+
+static int
+defSkipFilterClose(void *cookie)
+{
+  DefSkipFilter *filter = static_cast<DefSkipFilter*>(cookie);
+  int result = fclose(filter->stream());
+  delete filter;
+  return result;
+}
+
+DefSkipFilter::DefSkipFilter(FILE *stream,
+			     const DefSkip &skip) :
+  stream_(stream),
+  skip_(skip),
+  line_(nullptr),
+  line_size_(0),
+  text_pos_(0),
+  skip_section_(nullptr),
+  in_nets_(false),
+  in_routing_(false),
+  in_quote_(false)
+{
+}
+
+DefSkipFilter::~DefSkipFilter()
+{
+  free(line_);
+}
+
+ssize_t
+DefSkipFilter::read(char *buffer,
+		    size_t size)
+{
+  while (text_pos_ == text_.size()) {
+    text_.clear();
+    text_pos_ = 0;
+    if (getline(&line_, &line_size_, stream_) < 0)
+      return 0;
+    filterLine(line_);
+  }
+  size_t read_size = min(size, text_.size() - text_pos_);
+  memcpy(buffer, text_.data() + text_pos_, read_size);
+  text_pos_ += read_size;
+  return read_size;
+}
+
+// True if line starts with keyword followed by white space.
+static bool
+defLineBegins(const char *line,
+	      const char *keyword)
+{
+  while (*line == ' ' || *line == '\t')
+    line++;
+  size_t length = strlen(keyword);
+  return strncmp(line, keyword, length) == 0
+    && (line[length] == '\0' || isspace(line[length]));
+}
+
+// True if line is "END section".
+static bool
+defSectionEnd(const char *line,
+	      const char *section)
+{
+  while (*line == ' ' || *line == '\t')
+    line++;
+  if (strncmp(line, "END", 3) == 0
+      && isspace(line[3])) {
+    line += 3;
+    return defLineBegins(line, section);
+  }
+  return false;
+}
+
+void
+DefSkipFilter::filterLine(const char *line)
+{
+  if (skip_section_) {
+    if (defSectionEnd(line, skip_section_))
+      skip_section_ = nullptr;
+  }
+  else if (skip_.special_nets_ && defLineBegins(line, "SPECIALNETS"))
+    skip_section_ = "SPECIALNETS";
+  else if (skip_.fills_ && defLineBegins(line, "FILLS"))
+    skip_section_ = "FILLS";
+  else if (skip_.blockages_ && defLineBegins(line, "BLOCKAGES"))
+    skip_section_ = "BLOCKAGES";
+  else if (in_nets_) {
+    if (defSectionEnd(line, "NETS")) {
+      in_nets_ = false;
+      text_ += line;
+    }
+    else if (skip_.routing_)
+      filterNetsText(line);
+    else
+      text_ += line;
+  }
+  else {
+    in_nets_ = defLineBegins(line, "NETS");
+    text_ += line;
+  }
+}
+
+// Start of the first "+ ROUTED", "+ FIXED", "+ COVER" or "+ NOSHIELD"
+// in text or null.
+static const char *
+findNetRouting(const char *text)
+{
+  static const char *routing_keywords[] = {"ROUTED", "FIXED", "COVER",
+					   "NOSHIELD"};
+  for (const char *plus = strchr(text, '+'); plus; plus = strchr(plus + 1, '+')) {
+    const char *keyword = plus + 1;
+    while (*keyword == ' ' || *keyword == '\t')
+      keyword++;
+    for (const char *routing_keyword : routing_keywords) {
+      if (defLineBegins(keyword, routing_keyword))
+	return plus;
+    }
+  }
+  return nullptr;
+}
+
+// Drop the routing of NETS records, from the routing keyword to the
+// ';' that ends the record. Later net options are dropped with it.
+void
+DefSkipFilter::filterNetsText(const char *text)
+{
+  while (*text) {
+    if (in_routing_) {
+      const char *semi = routingEnd(text);
+      if (semi == nullptr)
+	return;
+      in_routing_ = false;
+      text = semi;
+    }
+    else {
+      const char *routing = findNetRouting(text);
+      if (routing == nullptr) {
+	text_ += text;
+	return;
+      }
+      text_.append(text, routing - text);
+      in_routing_ = true;
+      text = routing;
+    }
+  }
+}
+
+// The ';' that ends the routing being dropped or null if it is not in
+// text. Quoted PROPERTY values after the routing may hold a ';'.
+const char *
+DefSkipFilter::routingEnd(const char *text)
+{
+  for (const char *s = text; *s; s++) {
+    if (*s == '"')
+      in_quote_ = !in_quote_;
+    else if (*s == ';' && !in_quote_)
+      return s;
+  }
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Hash the component names for the DEF NETS lookups while it is in
+// scope so the index is deleted however the read ends.
+class DefComponentNameIndex
+{
+public:
+  DefComponentNameIndex(LefDefNetwork *network);
+  ~DefComponentNameIndex();
+
+private:
+  LefDefNetwork *network_;
+};
+
+DefComponentNameIndex::DefComponentNameIndex(LefDefNetwork *network) :
+  network_(network)
+{
+  network_->indexComponentNames();
+}
+
+DefComponentNameIndex::~DefComponentNameIndex()
+{
+  network_->deleteComponentNames();
+}
+
+////////////////////////////////////////////////////////////////
+
 void
 readDef(const char *filename,
 	bool save_def_data,
+	const DefSkip &skip,
+	bool fast,
+	int thread_count,
 	LefDefNetwork *network)
 {
   network->setDefFilename(filename);
@@ -94,10 +383,21 @@ readDef(const char *filename,
   // Note that top ports are not known yet because PINS section has not been parsed.
   Library *lef_library = network->lefLibrary();
   if (lef_library) {
+    DefComponentNameIndex name_index(network);
+    if (fast
+	&& readDefFast(filename, save_def_data, skip, thread_count, network))
+      return;
+    debugPrint1(network->debug(), "def_reader", 1,
+		"reading %s with the Si2 parser\n",
+		filename);
     defrInitSession();
     registerDefCallbacks();
     DefReader reader(save_def_data, network);
-    FILE *stream = fopen(filename, "r");
+    FILE *stream = openReadStream(filename);
+    if (stream
+	&& (skip.routing_ || skip.special_nets_ || skip.fills_
+	    || skip.blockages_))
+      stream = openDefSkipStream(stream, skip);
     if (stream) {
       bool case_sensitive = true;
       defrRead(stream, filename, &reader, case_sensitive);
@@ -119,6 +419,7 @@ registerDefCallbacks()
   defrSetBusBitCbk(defBusBitCbk);
   defrSetUnitsCbk(defUnitsCbk);
   defrSetDieAreaCbk(defDieAreaCbk);
+  defrSetComponentStartCbk(defComponentStartCbk);
   defrSetComponentCbk(defComponentCbk);
   defrSetNetCbk(defNetCbk);
   defrSetPinCbk(defPinCbk);
@@ -206,6 +507,16 @@ defDieAreaCbk(defrCallbackType_e,
   return 0;
 }
 
+static int
+defComponentStartCbk(defrCallbackType_e,
+		     int count,
+		     defiUserData user)
+{
+  LefDefNetwork *network = getNetwork(user);
+  network->reserveDefComponents(count);
+  return 0;
+}
+
 static int
 defComponentCbk(defrCallbackType_e,
 		defiComponent *def_component,
@@ -219,9 +530,7 @@ defComponentCbk(defrCallbackType_e,
   Cell *cell = network->findCell(lef_lib, macro_name);
   if (cell)
     network->makeDefComponent(cell, sta_name,
-			      saveDefData(user)
-			      ? new defiComponent(*def_component)
-			      : nullptr);
+			      saveDefData(user) ? def_component : nullptr);
   else
     defError(user, "Error: component %s macro %s not found.\n", def_name, macro_name);
   return 0;
@@ -239,25 +548,9 @@ defPinCbk(defrCallbackType_e,
   Cell *top_cell = network->cell(network->topInstance());
   Port *port = network->makePort(top_cell, pin_name);
 
-  PortDirection *dir = PortDirection::unknown();
-  if (def_pin->hasDirection()) {
-    const char *def_dir = def_pin->direction();
-    if (stringEq(def_dir, "INPUT"))
-      dir = PortDirection::input();
-    else if (stringEq(def_dir, "OUTPUT"))
-      dir = PortDirection::output();
-    else if (stringEq(def_dir, "OUTPUT TRISTATE"))
-      dir = PortDirection::tristate();
-    else if (stringEq(def_dir, "INOUT"))
-      dir = PortDirection::bidirect();
-  }
-  if (def_pin->hasUse()) {
-    const char *use = def_pin->use();
-    if (stringEq(use, "POWER"))
-      dir = PortDirection::power();
-    else if (stringEq(use, "GROUND"))
-      dir = PortDirection::ground();
-  }
+  PortDirection *dir =
+    defPinDirection(def_pin->hasDirection() ? def_pin->direction() : nullptr,
+		    def_pin->hasUse() ? def_pin->use() : nullptr);
   network->setDirection(port, dir);
 
   if (def_pin->isPlaced() || def_pin->isFixed() || def_pin->isCover())
@@ -288,49 +581,146 @@ defNetCbk(defrCallbackType_e,
   const char *def_net_name = def_net->name();
   const char *sta_net_name = defToSta(def_net_name, network);
   Net *net = network->makeNet(sta_net_name, network->topInstance());
-  for (int i = 0; i < def_net->numConnections(); i++) {
-    const char *def_inst_name = def_net->instance(i);
-    const char *sta_inst_name = defToSta(def_inst_name, network);
-    const char *pin_name = def_net->pin(i);
-    if (stringEq(def_inst_name, "PIN")) {
-      Instance *top_inst = network->topInstance();
-      Pin *pin = network->findPin(top_inst, pin_name);
-      if (pin == nullptr) {
-	Cell *cell = network->cell(top_inst);
-	Port *port = network->findPort(cell, pin_name);
-	if (port)
-	  pin = network->makePin(top_inst, port, nullptr);
-	else
-	  defError(user, "Error: net %s connection to PIN %s not found\n",
-		   def_net_name, pin_name);
-      }
-      if (pin)
-	network->makeTerm(pin, net);
+  for (int i = 0; i < def_net->numConnections(); i++)
+    defConnectNet(net, def_net_name, def_net->instance(i), def_net->pin(i),
+		  network);
+  return 0;
+}
+
+PortDirection *
+defPinDirection(const char *def_dir,
+		const char *use)
+{
+  PortDirection *dir = PortDirection::unknown();
+  if (def_dir) {
+    if (stringEq(def_dir, "INPUT"))
+      dir = PortDirection::input();
+    else if (stringEq(def_dir, "OUTPUT"))
+      dir = PortDirection::output();
+    else if (stringEq(def_dir, "OUTPUT TRISTATE"))
+      dir = PortDirection::tristate();
+    else if (stringEq(def_dir, "INOUT"))
+      dir = PortDirection::bidirect();
+  }
+  if (use) {
+    if (stringEq(use, "POWER"))
+      dir = PortDirection::power();
+    else if (stringEq(use, "GROUND"))
+      dir = PortDirection::ground();
+  }
+  return dir;
+}
+
+void
+defConnectNet(Net *net,
+	      const char *def_net_name,
+	      const char *def_inst_name,
+	      const char *pin_name,
+	      LefDefNetwork *network)
+{
+  Report *report = network->report();
+  if (stringEq(def_inst_name, "PIN")) {
+    Instance *top_inst = network->topInstance();
+    Pin *pin = network->findPin(top_inst, pin_name);
+    if (pin == nullptr) {
+      Cell *cell = network->cell(top_inst);
+      Port *port = network->findPort(cell, pin_name);
+      if (port)
+	pin = network->makePin(top_inst, port, nullptr);
+      else
+	report->printError("Error: net %s connection to PIN %s not found\n",
+			   def_net_name, pin_name);
     }
-    else {
-      Instance *top_inst = network->topInstance();
-      Instance *inst = network->findChild(top_inst, sta_inst_name);
-      if (inst) {
-	Cell *cell = network->cell(inst);
-	Port *port = network->findPort(cell, pin_name);
-	if (port)
-	  network->connect(inst, port, net);
-	else
-	  defError(user, "Error: net %s connection to component %s/%s pin %s not found.\n",
-		   def_net_name,
-		   def_inst_name,
-		   network->name(cell),
-		   pin_name);
-      }
+    if (pin)
+      network->makeTerm(pin, net);
+  }
+  else {
+    const char *sta_inst_name = defToSta(def_inst_name, network);
+    Instance *inst = network->findComponent(sta_inst_name);
+    if (inst) {
+      Cell *cell = network->cell(inst);
+      Port *port = network->findCellPort(cell, pin_name);
+      if (port)
+	network->connect(inst, port, net);
       else
-	defError(user, "Error: net %s connection component %s not found.\n",
-	       def_net_name,
-	       def_inst_name);
+	report->printError("Error: net %s connection to component %s/%s pin %s not found.\n",
+			   def_net_name,
+			   def_inst_name,
+			   network->name(cell),
+			   pin_name);
     }
+    else
+      report->printError("Error: net %s connection component %s not found.\n",
+			 def_net_name,
+			 def_inst_name);
   }
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+readDefShard(const char *filename,
+	     Report *report,
+	     // Return value.
+	     DefShardContents &contents)
+{
+  defrInitSession();
+  defrSetComponentCbk(defShardComponentCbk);
+  defrSetNetCbk(defShardNetCbk);
+  FILE *stream = openReadStream(filename);
+  if (stream) {
+    bool case_sensitive = true;
+    int status = defrRead(stream, filename, &contents, case_sensitive);
+    defrClear();
+    fclose(stream);
+    if (status != 0)
+      report->printError("Error: DEF shard %s could not be parsed.\n",
+			 filename);
+  }
+  else
+    throw FileNotReadable(filename);
+}
+
+#define getShardContents(user) (reinterpret_cast<DefShardContents *>(user))
+
+static int
+defShardComponentCbk(defrCallbackType_e,
+		     defiComponent *def_component,
+		     defiUserData user)
+{
+  DefShardContents *contents = getShardContents(user);
+  DefShardComponent component;
+  component.name_ = def_component->id();
+  component.macro_ = def_component->name();
+  component.is_placed_ = def_component->isPlaced()
+    || def_component->isFixed();
+  if (component.is_placed_)
+    component.location_ = DefPt(def_component->placementX(),
+				def_component->placementY());
+  contents->components_.push_back(component);
+  return 0;
+}
+
+static int
+defShardNetCbk(defrCallbackType_e,
+	       defiNet *def_net,
+	       defiUserData user)
+{
+  DefShardContents *contents = getShardContents(user);
+  DefShardNet net;
+  net.name_ = def_net->name();
+  for (int i = 0; i < def_net->numConnections(); i++) {
+    DefShardConnection connection;
+    connection.inst_name_ = def_net->instance(i);
+    connection.port_name_ = def_net->pin(i);
+    net.connections_.push_back(connection);
+  }
+  contents->nets_.push_back(net);
   return 0;
 }
 
+////////////////////////////////////////////////////////////////
+
 // Nada.
 // Note that the DEF names violate the normal sta namespace conventions
 // because the netlist is flattend.
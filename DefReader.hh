@@ -20,11 +20,56 @@
 namespace sta {
 
 class LefDefNetwork;
+class DefShardContents;
+class Report;
+class PortDirection;
+class Net;
 
+// DEF content that is not needed to build the network and is not
+// parsed when skipped. write_def copies it from the DEF file read, so
+// skipping it does not change the DEF written.
+class DefSkip
+{
+public:
+  DefSkip();
+  // Wiring of NETS (ROUTED, FIXED, COVER and NOSHIELD).
+  bool routing_;
+  bool special_nets_;
+  bool fills_;
+  bool blockages_;
+};
+
+// With fast the COMPONENTS and NETS sections are read by thread_count
+// threads with readDefFast. Files it does not handle, and all files
+// without fast, are read with the Si2 DEF parser.
 void
 readDef(const char *filename,
 	bool save_def_data,
+	const DefSkip &skip,
+	bool fast,
+	int thread_count,
 	LefDefNetwork *network);
+// Read the component and net names of a DEF file written by
+// writeDefShard (or a resized copy of one) without building a network.
+void
+readDefShard(const char *filename,
+	     Report *report,
+	     // Return value.
+	     DefShardContents &contents);
+
+// Shared by the DEF readers.
+// Direction of a PINS pin from its DIRECTION and USE (either may be null).
+PortDirection *
+defPinDirection(const char *def_dir,
+		const char *use);
+// Connect a NETS connection to net. def_inst_name is "PIN" for top
+// level pins.
+void
+defConnectNet(Net *net,
+	      const char *def_net_name,
+	      const char *def_inst_name,
+	      const char *pin_name,
+	      LefDefNetwork *network);
 
 } // namespace
 #endif
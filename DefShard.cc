@@ -0,0 +1,160 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Machine.hh"
+#include "StringUtil.hh"
+#include "PortDirection.hh"
+#include "DefShard.hh"
+
+namespace sta {
+
+DefShardPort::DefShardPort(const char *name,
+			   Net *net,
+			   PortDirection *dir,
+			   Pin *top_pin,
+			   Pin *outside_pin) :
+  name_(name),
+  net_(net),
+  dir_(dir),
+  top_pin_(top_pin),
+  outside_pin_(outside_pin)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
+DefShard::DefShard(const InstanceSeq &insts,
+		   LefDefNetwork *network) :
+  insts_(insts),
+  network_(network)
+{
+  for (auto inst : insts_)
+    inst_set_.insert(inst);
+  // Net ports cannot take the names of the design ports.
+  InstancePinIterator *port_iter =
+    network_->pinIterator(network_->topInstance());
+  while (port_iter->hasNext()) {
+    Pin *pin = port_iter->next();
+    port_names_.insert(network_->portName(pin));
+  }
+  delete port_iter;
+  findNets();
+  for (auto net : nets_)
+    makePort(net);
+}
+
+bool
+DefShard::hasInstance(const Instance *inst) const
+{
+  return inst_set_.hasKey(inst);
+}
+
+void
+DefShard::findNets()
+{
+  Set<const Net*> visited;
+  for (auto inst : insts_) {
+    InstancePinIterator *pin_iter = network_->pinIterator(inst);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      Net *net = network_->net(pin);
+      if (net
+	  && !network_->isPower(net)
+	  && !network_->isGround(net)
+	  && !visited.hasKey(net)) {
+	visited.insert(net);
+	nets_.push_back(net);
+      }
+    }
+    delete pin_iter;
+  }
+}
+
+void
+DefShard::makePort(Net *net)
+{
+  Pin *top_pin = nullptr;
+  Pin *outside_drvr = nullptr;
+  Pin *outside_load = nullptr;
+  bool inside_drvr = false;
+  NetConnectedPinIterator *pin_iter = network_->connectedPinIterator(net);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (network_->isTopLevelPort(pin)) {
+      if (top_pin == nullptr)
+	top_pin = pin;
+      // Top level inputs drive the net from outside the shard.
+      if (network_->isDriver(pin) && outside_drvr == nullptr)
+	outside_drvr = pin;
+      else if (network_->isLoad(pin) && outside_load == nullptr)
+	outside_load = pin;
+    }
+    else if (hasInstance(network_->instance(pin))) {
+      if (network_->isDriver(pin))
+	inside_drvr = true;
+    }
+    else if (network_->isDriver(pin)) {
+      if (outside_drvr == nullptr)
+	outside_drvr = pin;
+    }
+    else if (outside_load == nullptr)
+      outside_load = pin;
+  }
+  delete pin_iter;
+
+  if (top_pin || outside_drvr || outside_load) {
+    string name = top_pin
+      ? string(network_->portName(top_pin))
+      : uniquePortName(network_->pathName(net));
+    PortDirection *dir;
+    Pin *outside_pin;
+    if (inside_drvr) {
+      dir = PortDirection::output();
+      outside_pin = outside_load;
+    }
+    else {
+      dir = PortDirection::input();
+      outside_pin = outside_drvr;
+    }
+    net_port_index_[net] = ports_.size();
+    ports_.push_back(DefShardPort(name.c_str(), net, dir, top_pin,
+				  outside_pin));
+  }
+}
+
+string
+DefShard::uniquePortName(const char *net_name)
+{
+  string name = net_name;
+  for (int i = 1; port_names_.hasKey(name); i++)
+    stringPrint(name, "%s_%d", net_name, i);
+  port_names_.insert(name);
+  return name;
+}
+
+const DefShardPort *
+DefShard::findPort(const Net *net) const
+{
+  int index;
+  bool exists;
+  net_port_index_.findKey(net, index, exists);
+  if (exists)
+    return &ports_[index];
+  else
+    return nullptr;
+}
+
+} // namespace
@@ -0,0 +1,129 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_DEF_SHARD_H
+#define RESIZER_DEF_SHARD_H
+
+#include <string>
+#include "Vector.hh"
+#include "Set.hh"
+#include "NetworkClass.hh"
+#include "LefDefNetwork.hh"
+
+namespace sta {
+
+using std::string;
+
+class PortDirection;
+
+// Top level port of a shard. Nets that connect to components outside
+// the shard or to top level ports of the design get one port.
+// Ports on nets with a design top level port use the port name.
+// Other ports use the net name, with a _<n> suffix if that is the
+// name of a design port or another shard port.
+class DefShardPort
+{
+public:
+  DefShardPort(const char *name,
+	       Net *net,
+	       PortDirection *dir,
+	       Pin *top_pin,
+	       Pin *outside_pin);
+  const char *name() const { return name_.c_str(); }
+  Net *net() const { return net_; }
+  PortDirection *direction() const { return dir_; }
+  // Design top level pin on the net, if any.
+  Pin *topPin() const { return top_pin_; }
+  // Driver (input ports) or load (output ports) outside the shard.
+  Pin *outsidePin() const { return outside_pin_; }
+
+private:
+  string name_;
+  Net *net_;
+  PortDirection *dir_;
+  Pin *top_pin_;
+  Pin *outside_pin_;
+};
+
+typedef Vector<DefShardPort> DefShardPortSeq;
+typedef Set<const Instance*> ShardInstanceSet;
+
+// A region of the design written as a stand alone DEF so it can be
+// resized by a separate process.
+class DefShard
+{
+public:
+  DefShard(const InstanceSeq &insts,
+	   LefDefNetwork *network);
+  const InstanceSeq &instances() const { return insts_; }
+  bool hasInstance(const Instance *inst) const;
+  // Nets connected to the shard instances, in instance order.
+  const NetSeq &nets() const { return nets_; }
+  const DefShardPortSeq &ports() const { return ports_; }
+  // Port for net or nullptr if the net is inside the shard.
+  const DefShardPort *findPort(const Net *net) const;
+
+protected:
+  void findNets();
+  void makePort(Net *net);
+  string uniquePortName(const char *net_name);
+
+  InstanceSeq insts_;
+  ShardInstanceSet inst_set_;
+  NetSeq nets_;
+  DefShardPortSeq ports_;
+  UnorderedMap<const Net*, int> net_port_index_;
+  // Design top level port names and the shard port names.
+  Set<string> port_names_;
+  LefDefNetwork *network_;
+};
+
+////////////////////////////////////////////////////////////////
+
+// Components and nets read back from a shard DEF.
+class DefShardComponent
+{
+public:
+  string name_;
+  string macro_;
+  bool is_placed_;
+  DefPt location_;
+};
+
+class DefShardConnection
+{
+public:
+  // "PIN" for top level ports.
+  string inst_name_;
+  string port_name_;
+};
+
+class DefShardNet
+{
+public:
+  string name_;
+  Vector<DefShardConnection> connections_;
+};
+
+class DefShardContents
+{
+public:
+  Vector<DefShardComponent> components_;
+  Vector<DefShardNet> nets_;
+};
+
+} // namespace
+#endif
@@ -26,6 +26,8 @@
 #include "PortDirection.hh"
 #include "LefDefNetwork.hh"
 #include "NetworkCmp.hh"
+#include "DefShard.hh"
+#include "CompressedFile.hh"
 #include "defiComponent.hpp"
 #include "defiNet.hpp"
 #include "lefiLayer.hpp"
@@ -61,8 +63,12 @@ class DefWriter
 public:
   DefWriter(const char *filename,
 	    bool sort,
+	    int compress_level,
+	    int thread_count,
 	    LefDefNetwork *network);
   void rewrite(const char *in_filename);
+  void rewriteShard(const char *in_filename,
+		    const DefShard *shard);
   void writeFresh(int units,
 		  double die_lx,
 		  double die_ly,
@@ -77,6 +83,8 @@ public:
 		  bool auto_place_pins);
 
 protected:
+  // Throws FileNotWritable if a write or the close failed.
+  void closeOutStream();
   void writeHeader(int units,
 		   // Die area.
 		   double die_lx,
@@ -115,12 +123,20 @@ protected:
   void writeNets(const Instance *inst);
   void writeNet(Net *net);
   bool hasTerminals(Net *net) const;
+  void writeShardComponents(const DefShard *shard);
+  void writeShardPins(const DefShard *shard);
+  void writeShardNets(const DefShard *shard);
+  void writeShardNet(const DefShard *shard,
+		     Net *net);
   const char *staToDef(const char *token);
   DefDbu metersToDbu(double dist) const;
 
   const char *filename_;
   int def_units_;		// dbu/micron
   bool sort_;
+  // Only used for compressed (.gz) files.
+  int compress_level_;
+  int thread_count_;
   LefDefNetwork *network_;
   FILE *out_stream_;
   Vector<Track> tracks_;
@@ -144,9 +160,11 @@ writeDef(const char *filename,
 	 const char *tracks_file,
 	 bool auto_place_pins,
 	 bool sort,
+	 int compress_level,
+	 int thread_count,
 	 LefDefNetwork *network)
 {
-  DefWriter writer(filename, sort, network);
+  DefWriter writer(filename, sort, compress_level, thread_count, network);
   const char *in_filename = network->defFilename();
   if (in_filename)
     writer.rewrite(in_filename);
@@ -159,9 +177,13 @@ writeDef(const char *filename,
 
 DefWriter::DefWriter(const char *filename,
 		     bool sort,
+		     int compress_level,
+		     int thread_count,
 		     LefDefNetwork *network) :
   filename_(filename),
   sort_(sort),
+  compress_level_(compress_level),
+  thread_count_(thread_count),
   network_(network)
 {
 }
@@ -182,7 +204,7 @@ DefWriter::writeFresh(int units,
 		      const char *tracks_file,
 		      bool auto_place_pins)
 {
-  out_stream_ = fopen(filename_, "w");
+  out_stream_ = openWriteStream(filename_, compress_level_, thread_count_);
   if (out_stream_) {
     def_units_ = units;
     writeHeader(units, die_lx, die_ly, die_ux, die_uy);
@@ -206,21 +228,32 @@ DefWriter::writeFresh(int units,
     writeNets();
     fprintf(out_stream_, "\nEND DESIGN\n");
 
-    fclose(out_stream_);
+    closeOutStream();
   }
   else
     throw FileNotWritable(filename_);
 }
 
+// Compressed streams only report write errors when they are closed.
+void
+DefWriter::closeOutStream()
+{
+  bool error = ferror(out_stream_) != 0;
+  error |= fclose(out_stream_) != 0;
+  out_stream_ = nullptr;
+  if (error)
+    throw FileNotWritable(filename_);
+}
+
 // The network came from a DEF file.
 // Preserve everything but the COMPONENT and NET sections by copying them
 // and replacing those sections.
 void
 DefWriter::rewrite(const char *in_filename)
 {
-  FILE *in_stream = fopen(in_filename, "r");
+  FILE *in_stream = openReadStream(in_filename);
   if (in_stream) {
-    out_stream_ = fopen(filename_, "w");
+    out_stream_ = openWriteStream(filename_, compress_level_, thread_count_);
     if (out_stream_) {
       size_t buffer_size = 128;
       char *buffer = new char[buffer_size];
@@ -245,16 +278,181 @@ DefWriter::rewrite(const char *in_filename)
 	  fputs(buffer, out_stream_);
       }
       delete [] buffer;
-      fclose(out_stream_);
+      fclose(in_stream);
+      closeOutStream();
     }
-    else
+    else {
+      fclose(in_stream);
       throw FileNotWritable(filename_);
-    fclose(in_stream);
+    }
   }
   else
     throw FileNotReadable(in_filename);
 }
 
+void
+writeDefShard(const char *filename,
+	      const DefShard *shard,
+	      bool sort,
+	      LefDefNetwork *network)
+{
+  DefWriter writer(filename, sort, compress_level_default, 1, network);
+  writer.rewriteShard(network->defFilename(), shard);
+}
+
+// Same as rewrite but the PINS section is replaced by the shard ports.
+void
+DefWriter::rewriteShard(const char *in_filename,
+			const DefShard *shard)
+{
+  FILE *in_stream = openReadStream(in_filename);
+  if (in_stream) {
+    out_stream_ = openWriteStream(filename_, compress_level_, thread_count_);
+    if (out_stream_) {
+      bool pins_written = false;
+      size_t buffer_size = 128;
+      char *buffer = new char[buffer_size];
+      while (getline(&buffer, &buffer_size, in_stream) >= 0) {
+	if (stringBeginEqual(buffer, "COMPONENTS ")) {
+	  do {
+	    getline(&buffer, &buffer_size, in_stream);
+	  } while (!stringBeginEqual(buffer, "END COMPONENTS")
+		   && !feof(in_stream));
+	  writeShardComponents(shard);
+	}
+	else if (stringBeginEqual(buffer, "PINS ")) {
+	  do {
+	    getline(&buffer, &buffer_size, in_stream);
+	  } while (!stringBeginEqual(buffer, "END PINS")
+		   && !feof(in_stream));
+	  writeShardPins(shard);
+	  pins_written = true;
+	}
+	else if (stringBeginEqual(buffer, "NETS ")) {
+	  do {
+	    getline(&buffer, &buffer_size, in_stream);
+	  } while (!stringBeginEqual(buffer, "END NETS")
+		   && !feof(in_stream));
+	  // Boundary ports are required even if the design has no pins.
+	  if (!pins_written) {
+	    writeShardPins(shard);
+	    fprintf(out_stream_, "\n");
+	    pins_written = true;
+	  }
+	  writeShardNets(shard);
+	}
+	else
+	  fputs(buffer, out_stream_);
+      }
+      delete [] buffer;
+      fclose(in_stream);
+      closeOutStream();
+    }
+    else {
+      fclose(in_stream);
+      throw FileNotWritable(filename_);
+    }
+  }
+  else
+    throw FileNotReadable(in_filename);
+}
+
+void
+DefWriter::writeShardComponents(const DefShard *shard)
+{
+  InstanceSeq insts = shard->instances();
+  fprintf(out_stream_, "COMPONENTS %d ;\n",
+	  static_cast<int>(insts.size()));
+  if (sort_)
+    sort(insts, InstancePathNameLess(network_));
+  for (auto inst : insts)
+    writeComponent(inst);
+  fprintf(out_stream_, "END COMPONENTS\n");
+}
+
+void
+DefWriter::writeShardPins(const DefShard *shard)
+{
+  const DefShardPortSeq &ports = shard->ports();
+  fprintf(out_stream_, "PINS %d ;\n",
+	  static_cast<int>(ports.size()));
+  for (auto &port : ports) {
+    fprintf(out_stream_, "- %s + NET %s + DIRECTION %s",
+	    staToDef(port.name()),
+	    staToDef(network_->pathName(port.net())),
+	    staToDef(port.direction()));
+    // Place boundary ports at the pin they stand in for so the shard
+    // sees the same wire length.
+    Pin *loc_pin = port.topPin() ? port.topPin() : port.outsidePin();
+    if (loc_pin && network_->isPlaced(loc_pin)) {
+      DefPt loc = network_->location(loc_pin);
+      fprintf(out_stream_, " + FIXED ( %d %d ) N", loc.x(), loc.y());
+    }
+    fprintf(out_stream_, " ;\n");
+  }
+  fprintf(out_stream_, "END PINS\n");
+}
+
+void
+DefWriter::writeShardNets(const DefShard *shard)
+{
+  NetSeq nets = shard->nets();
+  fprintf(out_stream_, "NETS %d ;\n",
+	  static_cast<int>(nets.size()));
+  if (sort_)
+    sort(nets, NetPathNameLess(network_));
+  for (auto net : nets)
+    writeShardNet(shard, net);
+  fprintf(out_stream_, "END NETS\n");
+}
+
+// Only the pins of shard components and the shard port are written.
+void
+DefWriter::writeShardNet(const DefShard *shard,
+			 Net *net)
+{
+  const char *def_net_name = staToDef(network_->pathName(net));
+  fprintf(out_stream_, "- %s", def_net_name);
+  int column = strlen(def_net_name) + 2;
+  int column_max = 80;
+
+  const DefShardPort *port = shard->findPort(net);
+  if (port) {
+    const char *def_port_name = staToDef(port->name());
+    fprintf(out_stream_, " ( PIN %s )", def_port_name);
+    column += strlen(def_port_name) + 9;
+  }
+
+  Vector<const Pin*> pins;
+  NetConnectedPinIterator *pin_iter = network_->connectedPinIterator(net);
+  while (pin_iter->hasNext()) {
+    const Pin *pin = pin_iter->next();
+    if (network_->isLeaf(pin)
+	&& shard->hasInstance(network_->instance(pin)))
+      pins.push_back(pin);
+  }
+  delete pin_iter;
+
+  if (sort_)
+    sort(pins, PinPathNameLess(network_));
+
+  for (auto pin : pins) {
+    const char *def_component_name =
+      staToDef(network_->pathName(network_->instance(pin)));
+    const char *port_name = network_->portName(pin);
+    fprintf(out_stream_, " ( %s %s )",
+	    def_component_name,
+	    port_name);
+    int width = strlen(def_component_name) + strlen(port_name) + 6;
+    if ((column + width) > column_max) {
+      fprintf(out_stream_, "\n ");
+      column = 0;
+    }
+    column += width;
+  }
+  fprintf(out_stream_, " ;\n");
+}
+
 void
 DefWriter::writeHeader(int units,
 		       // Die area.
@@ -472,26 +670,29 @@ DefWriter::writeComponents()
 void
 DefWriter::writeComponent(Instance *inst)
 {
-  defiComponent *def_component = network_->defComponent(inst);
   fprintf(out_stream_, "- %s %s",
 	  staToDef(network_->pathName(inst)),
 	  network_->name(network_->cell(inst)));
-  if (def_component) {
-    if (def_component->hasEEQ())
-      fprintf(out_stream_, "\n+ EEQMASTER %s ", def_component->EEQ());
-    if (def_component->hasGenerate())
+  const DefComponentExtra *extra = network_->componentExtra(inst);
+  if (extra) {
+    if (!extra->eeq_.empty())
+      fprintf(out_stream_, "\n+ EEQMASTER %s ", extra->eeq_.c_str());
+    if (!extra->generate_name_.empty())
       fprintf(out_stream_, "\n+ GENERATE %s %s",
-	      def_component->generateName(),
-	      def_component->macroName());
-    if (def_component->hasSource())
-      fprintf(out_stream_, "\n+ SOURCE %s", def_component->source());
-    if (def_component->hasForeignName())
+	      extra->generate_name_.c_str(),
+	      extra->generate_macro_.c_str());
+    if (!extra->source_.empty())
+      fprintf(out_stream_, "\n+ SOURCE %s", extra->source_.c_str());
+    if (extra->has_foreign_)
       fprintf(out_stream_, "\n+ FOREIGN %s ( %d %d ) %s",
-	      def_component->foreignName(),
-	      def_component->foreignX(),
-	      def_component->foreignY(),
-	      def_component->foreignOri());
-    int status = def_component->placementStatus();
+	      extra->foreign_name_.c_str(),
+	      extra->foreign_x_,
+	      extra->foreign_y_,
+	      extra->foreign_orient_.c_str());
+  }
+  const DefPlacement *placement = network_->placement(inst);
+  if (placement) {
+    int status = placement->status();
     if (status) {
       if (status == DEFI_COMPONENT_UNPLACED)
 	fprintf(out_stream_, "\n+ UNPLACED");
@@ -508,25 +709,28 @@ DefWriter::writeComponent(Instance *inst)
 	  status_key = "COVER";
 	  break;
 	}
+	DefPt location = placement->location();
 	fprintf(out_stream_, "\n+ %s ( %d %d ) %s",
 		status_key,
-		def_component->placementX(),
-		def_component->placementY(),
-		def_component->placementOrientStr());
+		location.x(),
+		location.y(),
+		placement->orientStr());
       }
     }
-    if (def_component->hasWeight())
+  }
+  if (extra) {
+    if (extra->has_weight_)
       fprintf(out_stream_, "\n+ WEIGHT %d",
-	      def_component->weight());
-    if (def_component->hasRegionName())
+	      extra->weight_);
+    if (!extra->region_name_.empty())
       fprintf(out_stream_, "\n+ REGION %s",
-	      def_component->regionName());
-    if (def_component->hasRegionBounds()) {
-      int size, *xl, *yl, *xh, *yh;
-      def_component->regionBounds(&size, &xl, &yl, &xh, &yh);
+	      extra->region_name_.c_str());
+    if (extra->has_region_bounds_)
       fprintf(out_stream_, "\n+ REGION ( %d %d ) ( %d %d )",
-	      xl[0], yl[0], xh[0], yh[0]);
-    }
+	      extra->region_lx_,
+	      extra->region_ly_,
+	      extra->region_ux_,
+	      extra->region_uy_);
   }
   fprintf(out_stream_, " ;\n");
 }
@@ -20,6 +20,7 @@
 namespace sta {
 
 class LefDefNetwork;
+class DefShard;
 
 void
 writeDef(const char *filename,
@@ -42,7 +43,20 @@ writeDef(const char *filename,
 	 // Place pins around the die area boundary.
 	 bool auto_place_pins,
 	 bool sort,
+	 // Files ending in ".gz" are compressed at compress_level by
+	 // thread_count threads.
+	 int compress_level,
+	 int thread_count,
 	 LefDefNetwork *network);
 
+// Write the components, nets and ports of shard into a copy of the
+// DEF file the network was read from. Everything else in the DEF file
+// is copied unchanged.
+void
+writeDefShard(const char *filename,
+	      const DefShard *shard,
+	      bool sort,
+	      LefDefNetwork *network);
+
 } // namespace
 #endif
@@ -15,19 +15,35 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Machine.hh"
+#include "Report.hh"
+#include "ReportStd.hh"
 #include "Liberty.hh"
+#include "LibertyReader.hh"
 #include "SdcNetwork.hh"
 #include "LefDefNetwork.hh"
 
 namespace sta {
 
 using std::round;
+using std::min;
+using std::max;
+
+template <class OBJ>
+static void
+initSpatialIndex(SpatialIndex<OBJ, DefPt> &index,
+		 const Vector<OBJ> &objs,
+		 const Vector<DefPt> &locs);
 
 LefDefNetwork::LefDefNetwork() :
   ConcreteNetwork(),
   def_filename_(nullptr),
   lef_library_(nullptr),
-  manufacturing_grid_(0.0)
+  manufacturing_grid_(0.0),
+  component_names_indexed_(false),
+  cell_data_valid_(false),
+  spatial_index_valid_(false),
+  edit_epoch_(0),
+  design_epoch_(0)
 {
 }
 
@@ -42,14 +58,38 @@ LefDefNetwork::clear()
   stringDelete(def_filename_);
   def_filename_ = nullptr;
   lef_library_ = nullptr;
-  def_component_map_.deleteContentsClear();
+  placements_.clear();
+  placement_index_.clear();
+  placement_free_.clear();
+  component_extras_.clear();
+  deleteComponentNames();
+  cell_port_names_.clear();
   lef_macro_map_.deleteContents();
   lef_size_map_.deleteContents();
   manufacturing_grid_ = 0.0;
   lef_layers_.clear();
+  cell_data_.clear();
+  cell_data_index_.clear();
+  cell_data_valid_ = false;
+  inst_index_.clear();
+  port_index_.clear();
+  spatial_index_valid_ = false;
+  edit_epoch_++;
+  design_epoch_++;
   ConcreteNetwork::clear();
 }
 
+// read_verilog/link_design replace the design without clearing the network.
+bool
+LefDefNetwork::linkNetwork(const char *top_cell_name,
+			   bool make_black_boxes,
+			   Report *report)
+{
+  edit_epoch_++;
+  design_epoch_++;
+  return ConcreteNetwork::linkNetwork(top_cell_name, make_black_boxes, report);
+}
+
 void
 LefDefNetwork::initState(Report *report,
 			 Debug *debug)
@@ -100,14 +140,31 @@ LefDefNetwork::makeLefLibrary(const char *name,
 			      const char *filename)
 {
   lef_library_ = ConcreteNetwork::makeLibrary(name, filename);
+  cell_data_valid_ = false;
   return lef_library_;
 }
 
+LibertyLibrary *
+LefDefNetwork::makeLibertyLibrary(const char *name,
+				  const char *filename)
+{
+  cell_data_valid_ = false;
+  return ConcreteNetwork::makeLibertyLibrary(name, filename);
+}
+
+void
+LefDefNetwork::addLibertyLibrary(LibertyLibrary *library)
+{
+  addLibrary(library);
+  cell_data_valid_ = false;
+}
+
 void
 LefDefNetwork::setLefMacro(Cell *cell,
 			   lefiMacro *lef_macro)
 {
   lef_macro_map_[cell] = lef_macro;
+  cell_data_valid_ = false;
 }
 
 lefiMacro *
@@ -119,7 +176,8 @@ LefDefNetwork::lefMacro(Cell *cell) const
 Cell *
 LefDefNetwork::lefCell(LibertyCell *cell)
 {
-  return findCell(lef_library_, cell->name());
+  const CellData *cell_data = cellData(cell);
+  return cell_data ? cell_data->lefCell() : nullptr;
 }
 
 bool
@@ -128,6 +186,57 @@ LefDefNetwork::isLefCell(Cell *cell) const
   return library(cell) == lef_library_;
 }
 
+void
+LefDefNetwork::linkLibertyCell(Cell *lef_cell)
+{
+  LibertyCell *lib_cell = findLibertyCell(name(lef_cell));
+  if (lib_cell) {
+    ConcreteCell *ccell = reinterpret_cast<ConcreteCell*>(lef_cell);
+    ccell->setLibertyCell(lib_cell);
+    CellPortIterator *port_iter = portIterator(lef_cell);
+    while (port_iter->hasNext()) {
+      Port *port = port_iter->next();
+      const char *port_name = name(port);
+      LibertyPort *lib_port = lib_cell->findLibertyPort(port_name);
+      if (lib_port) {
+	ConcretePort *cport = reinterpret_cast<ConcretePort*>(port);
+	cport->setLibertyPort(lib_port);
+
+	if (isBus(port)) {
+	  PortMemberIterator *member_iter = memberIterator(port);
+	  while (member_iter->hasNext()) {
+	    Port *member = member_iter->next();
+	    const char *member_name = name(member);
+	    LibertyPort *member_lport = lib_cell->findLibertyPort(member_name);
+	    if (member_lport) {
+	      ConcretePort *member_cport = reinterpret_cast<ConcretePort*>(member);
+	      member_cport->setLibertyPort(member_lport);
+	    }
+	  }
+	  delete member_iter;
+	}
+      }
+    }
+    delete port_iter;
+  }
+}
+
+void
+LefDefNetwork::linkLibertyCells()
+{
+  if (lef_library_) {
+    LibraryCellIterator *cell_iter = libraryCellIterator(lef_library_);
+    while (cell_iter->hasNext()) {
+      Cell *lef_cell = cell_iter->next();
+      // Skip the DEF design cell.
+      if (isLeaf(lef_cell))
+	linkLibertyCell(lef_cell);
+    }
+    delete cell_iter;
+  }
+  cell_data_valid_ = false;
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
@@ -162,46 +271,173 @@ LefDefNetwork::initTopInstancePins()
   ctop_inst->initPins();
 }
 
+void
+LefDefNetwork::reserveDefComponents(int count)
+{
+  placements_.reserve(placements_.size() + count);
+  placement_index_.reserve(placement_index_.size() + count);
+  if (component_names_indexed_)
+    component_names_.reserve(component_names_.size() + count);
+}
+
+void
+LefDefNetwork::indexComponentNames()
+{
+  component_names_indexed_ = true;
+}
+
+void
+LefDefNetwork::deleteComponentNames()
+{
+  component_names_indexed_ = false;
+  // clear() keeps the buckets.
+  InstanceNameMap empty;
+  component_names_.swap(empty);
+}
+
+Instance *
+LefDefNetwork::findComponent(const char *name) const
+{
+  Instance *inst = component_names_.findKey(name);
+  if (inst == nullptr)
+    // Instances made by linking Verilog do not go through makeInstance.
+    inst = findChild(top_instance_, name);
+  return inst;
+}
+
+Port *
+LefDefNetwork::findCellPort(Cell *cell,
+			    const char *name)
+{
+  PortNameMap &port_names = cell_port_names_[cell];
+  Port *port = port_names.findKey(name);
+  if (port == nullptr) {
+    port = findPort(cell, name);
+    // The port name is the key so it must match the name found.
+    if (port && strcmp(this->name(port), name) == 0)
+      port_names[this->name(port)] = port;
+  }
+  return port;
+}
+
 Instance *
 LefDefNetwork::makeDefComponent(Cell *cell,
 				const char *name,
 				defiComponent *def_component)
 {
   Instance *inst = makeInstance(cell, name, top_instance_);
-  if (def_component)
-    def_component_map_[inst] = def_component;
+  if (def_component) {
+    setPlacement(inst,
+		 DefPt(def_component->placementX(),
+		       def_component->placementY()),
+		 def_component->placementOrient(),
+		 def_component->placementStatus());
+    if (DefComponentExtra::hasExtra(def_component))
+      setComponentExtra(inst, DefComponentExtra(def_component));
+  }
   return inst;
 }
 
-defiComponent *
-LefDefNetwork::defComponent(Instance *inst) const
+DefPlacement *
+LefDefNetwork::findPlacement(const Instance *inst)
 {
-  return def_component_map_.findKey(inst);
+  int index;
+  bool exists;
+  placement_index_.findKey(inst, index, exists);
+  if (exists)
+    return &placements_[index];
+  else
+    return nullptr;
+}
+
+const DefPlacement *
+LefDefNetwork::placement(const Instance *inst) const
+{
+  int index;
+  bool exists;
+  placement_index_.findKey(inst, index, exists);
+  if (exists)
+    return &placements_[index];
+  else
+    return nullptr;
+}
+
+const DefComponentExtra *
+LefDefNetwork::componentExtra(const Instance *inst) const
+{
+  const DefPlacement *placement = this->placement(inst);
+  if (placement && placement->extra_index_ >= 0)
+    return &component_extras_[placement->extra_index_];
+  else
+    return nullptr;
+}
+
+void
+LefDefNetwork::setPlacement(Instance *inst,
+			    DefPt location,
+			    int orient,
+			    int status)
+{
+  DefPlacement *placement = findPlacement(inst);
+  if (placement) {
+    placement->x_ = location.x();
+    placement->y_ = location.y();
+    placement->orient_ = orient;
+    placement->status_ = status;
+  }
+  else {
+    DefPlacement new_placement(inst, location, orient, status);
+    if (placement_free_.empty()) {
+      placement_index_[inst] = placements_.size();
+      placements_.push_back(new_placement);
+    }
+    else {
+      int index = placement_free_.back();
+      placement_free_.pop_back();
+      placement_index_[inst] = index;
+      placements_[index] = new_placement;
+    }
+  }
+  if (spatial_index_valid_) {
+    if (status == DEFI_COMPONENT_PLACED)
+      inst_index_.insert(inst, location);
+    else
+      inst_index_.remove(inst);
+  }
+}
+
+void
+LefDefNetwork::setComponentExtra(Instance *inst,
+				 const DefComponentExtra &extra)
+{
+  DefPlacement *placement = findPlacement(inst);
+  if (placement == nullptr) {
+    setPlacement(inst, DefPt(0, 0), 0, 0);
+    placement = findPlacement(inst);
+  }
+  if (placement->extra_index_ >= 0)
+    component_extras_[placement->extra_index_] = extra;
+  else {
+    placement->extra_index_ = component_extras_.size();
+    component_extras_.push_back(extra);
+  }
 }
 
 void
 LefDefNetwork::setLocation(Instance *instance,
 			   DefPt location)
 {
-  defiComponent *def_component = defComponent(instance);
-  if (def_component == nullptr) {
-    def_component = new defiComponent(nullptr);
-    def_component_map_[instance] = def_component;
-  }
-  def_component->setPlacementStatus(DEFI_COMPONENT_PLACED);
-  def_component->setPlacementLocation(location.x(), location.y(), 0);
+  setPlacement(instance, location, 0, DEFI_COMPONENT_PLACED);
 }
 
 DefPt
 LefDefNetwork::location(const Pin *pin) const
 {
-  Instance *inst = instance(pin);
-  defiComponent *def_component = def_component_map_.findKey(inst);
-  if (def_component
-      && def_component->isPlaced()) {
+  const DefPlacement *placement = this->placement(instance(pin));
+  if (placement
+      && placement->isPlaced()) {
     // Component location is good enough for now.
-    return DefPt(def_component->placementX(),
-		 def_component->placementY());
+    return placement->location();
   }
   else if (isTopLevelPort(pin)) {
     Port *port = this->port(pin);
@@ -219,6 +455,13 @@ LefDefNetwork::setLocation(Port *port,
 			   DefPt location)
 {
   port_locations_[port] = location;
+  if (spatial_index_valid_) {
+    Pin *pin = findPin(top_instance_, port);
+    if (pin)
+      port_index_.insert(pin, location);
+    else
+      spatial_index_valid_ = false;
+  }
 }
 
 bool
@@ -228,16 +471,16 @@ LefDefNetwork::isPlaced(const Pin *pin) const
   if (inst == top_instance_)
     return port_locations_.hasKey(port(pin));
   else {
-    defiComponent *def_component = defComponent(inst);
-    return def_component
-      && def_component->isPlaced();
+    const DefPlacement *placement = this->placement(inst);
+    return placement
+      && placement->isPlaced();
   }
 }
 
 Instance *
 LefDefNetwork::findInstance(const char *path_name) const
 {
-  return findChild(top_instance_, path_name);
+  return findComponent(path_name);
 }
 
 Net *
@@ -246,6 +489,170 @@ LefDefNetwork::findNet(const char *path_name) const
   return findNet(top_instance_, path_name);
 }
 
+Instance *
+LefDefNetwork::makeInstance(Cell *cell,
+			    const char *name,
+			    Instance *parent)
+{
+  edit_epoch_++;
+  Instance *inst = ConcreteNetwork::makeInstance(cell, name, parent);
+  if (component_names_indexed_
+      && parent
+      && parent == top_instance_)
+    component_names_[this->name(inst)] = inst;
+  return inst;
+}
+
+Instance *
+LefDefNetwork::makeInstance(LibertyCell *cell,
+			    const char *name,
+			    Instance *parent)
+{
+  edit_epoch_++;
+  Instance *inst = ConcreteNetwork::makeInstance(cell, name, parent);
+  if (component_names_indexed_
+      && parent
+      && parent == top_instance_)
+    component_names_[this->name(inst)] = inst;
+  return inst;
+}
+
+void
+LefDefNetwork::deleteInstance(Instance *inst)
+{
+  edit_epoch_++;
+  int index;
+  bool exists;
+  placement_index_.findKey(inst, index, exists);
+  if (exists) {
+    DefPlacement &placement = placements_[index];
+    if (placement.extra_index_ >= 0)
+      // Release the strings; the slot is not reused.
+      component_extras_[placement.extra_index_] = DefComponentExtra();
+    placement = DefPlacement(nullptr, DefPt(0, 0), 0, 0);
+    placement_index_.erase(inst);
+    placement_free_.push_back(index);
+  }
+  if (spatial_index_valid_)
+    inst_index_.remove(inst);
+  if (component_names_indexed_
+      && parent(inst) == top_instance_)
+    component_names_.erase(name(inst));
+  ConcreteNetwork::deleteInstance(inst);
+}
+
+Net *
+LefDefNetwork::makeNet(const char *name,
+		       Instance *parent)
+{
+  edit_epoch_++;
+  return ConcreteNetwork::makeNet(name, parent);
+}
+
+void
+LefDefNetwork::deleteNet(Net *net)
+{
+  edit_epoch_++;
+  ConcreteNetwork::deleteNet(net);
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+LefDefNetwork::ensureSpatialIndex()
+{
+  if (!spatial_index_valid_) {
+    // Use the bounding box of the locations because placements are
+    // not always inside the die area.
+    Vector<DefPt> inst_locs;
+    InstanceSeq insts;
+    for (const DefPlacement &placement : placements_) {
+      if (placement.isPlaced()) {
+	insts.push_back(placement.instance());
+	inst_locs.push_back(placement.location());
+      }
+    }
+    initSpatialIndex(inst_index_, insts, inst_locs);
+
+    Vector<DefPt> port_locs;
+    PinSeq pins;
+    for (auto port_location : port_locations_) {
+      Pin *pin = findPin(top_instance_, port_location.first);
+      if (pin) {
+	pins.push_back(pin);
+	port_locs.push_back(port_location.second);
+      }
+    }
+    initSpatialIndex(port_index_, pins, port_locs);
+    spatial_index_valid_ = true;
+  }
+}
+
+template <class OBJ>
+static void
+initSpatialIndex(SpatialIndex<OBJ, DefPt> &index,
+		 const Vector<OBJ> &objs,
+		 const Vector<DefPt> &locs)
+{
+  DefDbu lx = 0, ly = 0, ux = 0, uy = 0;
+  for (size_t i = 0; i < locs.size(); i++) {
+    DefPt loc = locs[i];
+    if (i == 0) {
+      lx = ux = loc.x();
+      ly = uy = loc.y();
+    }
+    else {
+      lx = min(lx, loc.x());
+      ly = min(ly, loc.y());
+      ux = max(ux, loc.x());
+      uy = max(uy, loc.y());
+    }
+  }
+  index.init(lx, ly, ux, uy, objs.size());
+  for (size_t i = 0; i < objs.size(); i++)
+    index.insert(objs[i], locs[i]);
+}
+
+void
+LefDefNetwork::findInstancesInWindow(DefPt ll,
+				     DefPt ur,
+				     // Return value.
+				     InstanceSeq &insts)
+{
+  ensureSpatialIndex();
+  inst_index_.findInWindow(ll.x(), ll.y(), ur.x(), ur.y(), insts);
+}
+
+void
+LefDefNetwork::findNearestInstances(DefPt location,
+				    int count,
+				    // Return value.
+				    InstanceSeq &insts)
+{
+  ensureSpatialIndex();
+  inst_index_.findNearest(location, count, insts);
+}
+
+void
+LefDefNetwork::findPortsInWindow(DefPt ll,
+				 DefPt ur,
+				 // Return value.
+				 PinSeq &pins)
+{
+  ensureSpatialIndex();
+  port_index_.findInWindow(ll.x(), ll.y(), ur.x(), ur.y(), pins);
+}
+
+void
+LefDefNetwork::findNearestPorts(DefPt location,
+				int count,
+				// Return value.
+				PinSeq &pins)
+{
+  ensureSpatialIndex();
+  port_index_.findNearest(location, count, pins);
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
@@ -285,24 +692,203 @@ LefDefNetwork::designArea()
 }
 
 double
-LefDefNetwork::area(Instance *inst) const
+LefDefNetwork::area(const Instance *inst)
 {
   return area(cell(inst));
 }
 
 double
-LefDefNetwork::area(Cell *cell) const
+LefDefNetwork::area(const Cell *cell)
 {
-  const char *cell_name = name(cell);
-  if (lef_library_) {
-    Cell *lef_cell = findCell(lef_library_, cell_name);
-    if (lef_cell) {
-      lefiMacro *lef_macro = lefMacro(lef_cell);
-      if (lef_macro && lef_macro->hasSize())
-	return lef_macro->sizeX() * 1e-6 * lef_macro->sizeY() * 1e-6;
+  const CellData *cell_data = cellData(cell);
+  return cell_data ? cell_data->area() : 0.0;
+}
+
+double
+LefDefNetwork::area(const LibertyCell *cell)
+{
+  const CellData *cell_data = cellData(cell);
+  return cell_data ? cell_data->area() : 0.0;
+}
+
+////////////////////////////////////////////////////////////////
+
+CellData::CellData(double area,
+		   Cell *lef_cell,
+		   LibertyCell *liberty_cell,
+		   lefiMacro *lef_macro) :
+  area_(area),
+  lef_cell_(lef_cell),
+  liberty_cell_(liberty_cell),
+  lef_macro_(lef_macro)
+{
+}
+
+const CellData *
+LefDefNetwork::cellData(const Cell *cell)
+{
+  ensureCellData();
+  int index;
+  bool exists;
+  cell_data_index_.findKey(cell, index, exists);
+  return exists ? &cell_data_[index] : nullptr;
+}
+
+const CellData *
+LefDefNetwork::cellData(const LibertyCell *cell)
+{
+  // Liberty cells are concrete cells.
+  const ConcreteCell *ccell = cell;
+  return cellData(reinterpret_cast<const Cell*>(ccell));
+}
+
+// Resolve the name lookups between LEF macros and liberty cells once.
+void
+LefDefNetwork::ensureCellData()
+{
+  if (!cell_data_valid_) {
+    cell_data_.clear();
+    cell_data_index_.clear();
+    if (lef_library_) {
+      LibraryCellIterator *cell_iter = libraryCellIterator(lef_library_);
+      while (cell_iter->hasNext()) {
+	Cell *lef_cell = cell_iter->next();
+	LibertyCell *lib_cell = findLibertyCell(name(lef_cell));
+	lefiMacro *lef_macro = lefMacro(lef_cell);
+	double area = 0.0;
+	if (lef_macro && lef_macro->hasSize())
+	  area = lef_macro->sizeX() * 1e-6 * lef_macro->sizeY() * 1e-6;
+	int index = cell_data_.size();
+	cell_data_.push_back(CellData(area, lef_cell, lib_cell, lef_macro));
+	cell_data_index_[lef_cell] = index;
+	if (lib_cell) {
+	  const ConcreteCell *lib_ccell = lib_cell;
+	  cell_data_index_[reinterpret_cast<const Cell*>(lib_ccell)] = index;
+	}
+      }
+      delete cell_iter;
+    }
+    // Liberty cells not found by the LEF macro name lookup above.
+    // Cells without LEF macros use the liberty area.
+    LibertyLibraryIterator *lib_iter = libertyLibraryIterator();
+    while (lib_iter->hasNext()) {
+      LibertyLibrary *lib = lib_iter->next();
+      LibertyCellIterator cell_iter(lib);
+      while (cell_iter.hasNext()) {
+	LibertyCell *lib_cell = cell_iter.next();
+	const ConcreteCell *lib_ccell = lib_cell;
+	const Cell *cell = reinterpret_cast<const Cell*>(lib_ccell);
+	if (!cell_data_index_.hasKey(cell)) {
+	  // Cells with the same name in other liberty libraries share
+	  // the LEF macro.
+	  Cell *lef_cell = lef_library_
+	    ? findCell(lef_library_, lib_cell->name())
+	    : nullptr;
+	  int index = cell_data_.size();
+	  if (lef_cell) {
+	    const CellData &lef_data = cell_data_[cell_data_index_[lef_cell]];
+	    cell_data_.push_back(CellData(lef_data.area(), lef_cell, lib_cell,
+					  lef_data.lefMacro()));
+	  }
+	  else {
+	    // Liberty area units are um^2.
+	    double area = lib_cell->area() * 1e-12;
+	    cell_data_.push_back(CellData(area, nullptr, lib_cell, nullptr));
+	  }
+	  cell_data_index_[cell] = index;
+	}
+      }
     }
+    delete lib_iter;
+    cell_data_valid_ = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+DefComponentExtra::DefComponentExtra() :
+  has_foreign_(false),
+  foreign_x_(0),
+  foreign_y_(0),
+  has_weight_(false),
+  weight_(0),
+  has_region_bounds_(false),
+  region_lx_(0),
+  region_ly_(0),
+  region_ux_(0),
+  region_uy_(0)
+{
+}
+
+DefComponentExtra::DefComponentExtra(defiComponent *def_component) :
+  DefComponentExtra()
+{
+  if (def_component->hasEEQ())
+    eeq_ = def_component->EEQ();
+  if (def_component->hasGenerate()) {
+    generate_name_ = def_component->generateName();
+    generate_macro_ = def_component->macroName();
+  }
+  if (def_component->hasSource())
+    source_ = def_component->source();
+  if (def_component->hasForeignName()) {
+    has_foreign_ = true;
+    foreign_name_ = def_component->foreignName();
+    foreign_x_ = def_component->foreignX();
+    foreign_y_ = def_component->foreignY();
+    foreign_orient_ = def_component->foreignOri();
   }
-  return 0.0;
+  if (def_component->hasWeight()) {
+    has_weight_ = true;
+    weight_ = def_component->weight();
+  }
+  if (def_component->hasRegionName())
+    region_name_ = def_component->regionName();
+  if (def_component->hasRegionBounds()) {
+    int size, *xl, *yl, *xh, *yh;
+    def_component->regionBounds(&size, &xl, &yl, &xh, &yh);
+    if (size > 0) {
+      has_region_bounds_ = true;
+      region_lx_ = xl[0];
+      region_ly_ = yl[0];
+      region_ux_ = xh[0];
+      region_uy_ = yh[0];
+    }
+  }
+}
+
+bool
+DefComponentExtra::hasExtra(defiComponent *def_component)
+{
+  return def_component->hasEEQ()
+    || def_component->hasGenerate()
+    || def_component->hasSource()
+    || def_component->hasForeignName()
+    || def_component->hasWeight()
+    || def_component->hasRegionName()
+    || def_component->hasRegionBounds();
+}
+
+DefPlacement::DefPlacement(Instance *inst,
+			   DefPt location,
+			   int orient,
+			   int status) :
+  inst_(inst),
+  x_(location.x()),
+  y_(location.y()),
+  orient_(orient),
+  status_(status),
+  extra_index_(-1)
+{
+}
+
+static const char *def_orient_names[] = {"N", "W", "S", "E",
+					 "FN", "FW", "FS", "FE"};
+
+const char *
+DefPlacement::orientStr() const
+{
+  return (orient_ < 8) ? def_orient_names[orient_] : "N";
 }
 
 ////////////////////////////////////////////////////////////////
@@ -320,4 +906,46 @@ DefPt::DefPt() :
 {
 }
 
+////////////////////////////////////////////////////////////////
+
+LibertyReadNetwork::LibertyReadNetwork(Debug *debug) :
+  ConcreteNetwork(),
+  read_report_(makeReportStd())
+{
+  initState(read_report_, debug);
+  read_report_->redirectStringBegin();
+}
+
+LibertyReadNetwork::~LibertyReadNetwork()
+{
+  // Libraries that were not released are deleted by ~ConcreteNetwork.
+  delete read_report_;
+}
+
+void
+LibertyReadNetwork::readLibertyFile(const char *filename,
+				    bool infer_latches)
+{
+  LibertyLibrary *library = sta::readLibertyFile(filename, infer_latches,
+						 this);
+  if (library)
+    libraries_.push_back(library);
+}
+
+const char *
+LibertyReadNetwork::messages()
+{
+  return read_report_->redirectStringEnd();
+}
+
+void
+LibertyReadNetwork::releaseLibraries(// Return value.
+				     LibertyLibrarySeq &libraries)
+{
+  libraries = libraries_;
+  libraries_.clear();
+  library_seq_.clear();
+  library_map_.clear();
+}
+
 } // namespace
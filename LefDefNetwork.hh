@@ -17,6 +17,10 @@
 #ifndef RESIZER_LEF_DEF_NETWORK_H
 #define RESIZER_LEF_DEF_NETWORK_H
 
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "Hash.hh"
 #include "UnorderedMap.hh"
 #include "ConcreteLibrary.hh"
 #include "ConcreteNetwork.hh"
@@ -24,9 +28,12 @@
 #include "lefiMacro.hpp"
 #include "defiComponent.hpp"
 #include "defiNet.hpp"
+#include "SpatialIndex.hh"
 
 namespace sta {
 
+using std::string;
+
 class DefPt;
 
 // Database location type used by DEF parser.
@@ -46,13 +53,128 @@ private:
   DefDbu y_;
 };
 
+// Cell metadata shared by a LEF macro and the liberty cell with
+// the same name.
+class CellData
+{
+public:
+  CellData(double area,
+	   Cell *lef_cell,
+	   LibertyCell *liberty_cell,
+	   lefiMacro *lef_macro);
+  // meters^2
+  double area() const { return area_; }
+  Cell *lefCell() const { return lef_cell_; }
+  LibertyCell *libertyCell() const { return liberty_cell_; }
+  lefiMacro *lefMacro() const { return lef_macro_; }
+
+private:
+  double area_;
+  Cell *lef_cell_;
+  LibertyCell *liberty_cell_;
+  lefiMacro *lef_macro_;
+};
+
+// DEF COMPONENTS fields other than the placement. Few components
+// have any of them, so they are kept in a side table.
+class DefComponentExtra
+{
+public:
+  DefComponentExtra();
+  explicit DefComponentExtra(defiComponent *def_component);
+  // True if def_component has any of the fields.
+  static bool hasExtra(defiComponent *def_component);
+
+  string eeq_;
+  string generate_name_;
+  string generate_macro_;
+  string source_;
+  bool has_foreign_;
+  string foreign_name_;
+  DefDbu foreign_x_;
+  DefDbu foreign_y_;
+  string foreign_orient_;
+  bool has_weight_;
+  int weight_;
+  string region_name_;
+  bool has_region_bounds_;
+  DefDbu region_lx_;
+  DefDbu region_ly_;
+  DefDbu region_ux_;
+  DefDbu region_uy_;
+};
+
+// Placement of a DEF component or an inserted instance.
+class DefPlacement
+{
+public:
+  DefPlacement(Instance *inst,
+	       DefPt location,
+	       int orient,
+	       int status);
+  Instance *instance() const { return inst_; }
+  DefPt location() const { return DefPt(x_, y_); }
+  // DEFI_COMPONENT_* placement status, 0 if the component has none.
+  int status() const { return status_; }
+  bool isPlaced() const { return status_ == DEFI_COMPONENT_PLACED; }
+  // DEF orientation index (N W S E FN FW FS FE).
+  int orient() const { return orient_; }
+  const char *orientStr() const;
+
+private:
+  Instance *inst_;
+  DefDbu x_;
+  DefDbu y_;
+  uint8_t orient_;
+  uint8_t status_;
+  // Index of the DefComponentExtra, or -1.
+  int extra_index_;
+
+  friend class LefDefNetwork;
+};
+
+// Hash for names owned by network objects.
+class DefNameHash
+{
+public:
+  size_t operator()(const char *name) const
+  {
+    size_t hash = hash_init_value;
+    for (const char *ch = name; *ch; ch++)
+      hashIncr(hash, *ch);
+    return hash;
+  }
+};
+
+class DefNameEqual
+{
+public:
+  bool operator()(const char *name1,
+		  const char *name2) const
+  {
+    return strcmp(name1, name2) == 0;
+  }
+};
+
 // No need to specializing ConcreteLibrary at this point.
 typedef UnorderedMap<Cell*, LibertyCell*> LibertyCellMap;
 typedef UnorderedMap<Port*, DefPt> DefPortLocations;
-typedef UnorderedMap<Instance*, defiComponent *> InstanceDefComponentMap;
+typedef Vector<DefPlacement> DefPlacementSeq;
+typedef Vector<DefComponentExtra> DefComponentExtraSeq;
+typedef UnorderedMap<const Instance*, int> InstancePlacementIndexMap;
 typedef UnorderedMap<Cell*, lefiMacro*> CellLefMacroMap;
 typedef Map<const char*, lefiSite*, CharPtrLess> LefSiteMap;
 typedef Vector<lefiLayer> LefLayerSeq;
+typedef Vector<CellData> CellDataSeq;
+typedef UnorderedMap<const Cell*, int> CellDataIndexMap;
+// Keys are the names of the instances and ports, so a name is stored once.
+typedef UnorderedMap<const char*, Instance*,
+		     DefNameHash, DefNameEqual> InstanceNameMap;
+typedef UnorderedMap<const char*, Port*,
+		     DefNameHash, DefNameEqual> PortNameMap;
+typedef UnorderedMap<const Cell*, PortNameMap> CellPortNameMap;
+typedef SpatialIndex<Instance*, DefPt> InstanceSpatialIndex;
+typedef SpatialIndex<Pin*, DefPt> PinSpatialIndex;
 
 class LefDefNetwork : public ConcreteNetwork
 {
@@ -90,6 +212,20 @@ public:
 		   lefiMacro *lef_macro);
   Cell *lefCell(LibertyCell *cell);
   bool isLefCell(Cell *cell) const;
+  // Set the liberty cell and ports of a LEF macro for reference
+  // by Network.
+  void linkLibertyCell(Cell *lef_cell);
+  void linkLibertyCells();
+  // Metadata for LEF and liberty cells.
+  // The table is built on first use after the LEF and liberty libraries
+  // are read, so it is not safe to build from multiple threads.
+  const CellData *cellData(const Cell *cell);
+  const CellData *cellData(const LibertyCell *cell);
+  void ensureCellData();
+  virtual LibertyLibrary *makeLibertyLibrary(const char *name,
+					     const char *filename);
+  // Add a library read by a LibertyReadNetwork.
+  void addLibertyLibrary(LibertyLibrary *library);
 
   // DEF
   void setDieArea(DefDbu die_lx,
@@ -102,10 +238,37 @@ public:
 	       DefDbu &die_ux,
 	       DefDbu &die_uy);
   void initTopInstancePins();
+  // Size the component tables for count more components (the DEF
+  // COMPONENTS count) so reading them does not rehash.
+  void reserveDefComponents(int count);
+  // Hash the names of the top level instances made until
+  // deleteComponentNames for the many lookups of reading DEF NETS.
+  // The placement index is the only permanent per instance table.
+  void indexComponentNames();
+  void deleteComponentNames();
+  // Top level instance by name. Hashed while reading DEF, otherwise the
+  // ordered child lookup of findChild.
+  Instance *findComponent(const char *name) const;
+  // findPort(cell, name) through a per cell hash table that is filled
+  // as ports are found, for the many lookups of reading DEF NETS.
+  Port *findCellPort(Cell *cell,
+		     const char *name);
+  // Make a component instance. The placement and other COMPONENTS
+  // fields of def_component are copied, so the parser can reuse it.
   Instance *makeDefComponent(Cell *cell,
 			     const char *name,
 			     defiComponent *def_component);
-  defiComponent *defComponent(Instance *inst) const;
+  // Placement of inst or nullptr if it has none.
+  // The pointer is only valid until the next placement is made.
+  const DefPlacement *placement(const Instance *inst) const;
+  // Other COMPONENTS fields of inst or nullptr if it has none.
+  const DefComponentExtra *componentExtra(const Instance *inst) const;
+  void setPlacement(Instance *inst,
+		    DefPt location,
+		    int orient,
+		    int status);
+  void setComponentExtra(Instance *inst,
+			 const DefComponentExtra &extra);
   // In DBUs.
   DefPt location(const Pin *pin) const;
   void setLocation(Instance *instance,
@@ -115,19 +278,63 @@ public:
 		   DefPt location);
   bool isPlaced(const Pin *pin) const;
   virtual Instance *findInstance(const char *path_name) const;
+  virtual Instance *makeInstance(Cell *cell,
+				 const char *name,
+				 Instance *parent);
+  virtual Instance *makeInstance(LibertyCell *cell,
+				 const char *name,
+				 Instance *parent);
+  virtual void deleteInstance(Instance *inst);
+  virtual Net *makeNet(const char *name,
+		       Instance *parent);
+  virtual void deleteNet(Net *net);
+  // Incremented when instances or nets are made or deleted so name
+  // indices can tell when they are out of date.
+  int editEpoch() const { return edit_epoch_; }
+  // Incremented when the network is cleared or a new design is linked.
+  int designEpoch() const { return design_epoch_; }
+  virtual bool linkNetwork(const char *top_cell_name,
+			   bool make_black_boxes,
+			   Report *report);
+
+  // Placed instance and top level port queries (DBUs).
+  // The index is built on the first query after the DEF is read and
+  // is updated by setLocation and deleteInstance.
+  void findInstancesInWindow(DefPt ll,
+			     DefPt ur,
+			     // Return value.
+			     InstanceSeq &insts);
+  // The count placed instances nearest to location, nearest first.
+  void findNearestInstances(DefPt location,
+			    int count,
+			    // Return value.
+			    InstanceSeq &insts);
+  void findPortsInWindow(DefPt ll,
+			 DefPt ur,
+			 // Return value.
+			 PinSeq &pins);
+  void findNearestPorts(DefPt location,
+			int count,
+			// Return value.
+			PinSeq &pins);
 
   virtual Net *findNet(const char *path_name) const;
   void connectedPins(const Net *net,
 		     PinSeq &pins);
 
-  double area(Cell *cell) const;
-  double area(Instance *inst) const;
+  // LEF macro size or liberty area (meters^2).
+  double area(const Cell *cell);
+  double area(const LibertyCell *cell);
+  double area(const Instance *inst);
   double designArea();
 
   using ConcreteNetwork::connect;
   using ConcreteNetwork::findNet;
 
 protected:
+  void ensureSpatialIndex();
+  DefPlacement *findPlacement(const Instance *inst);
+
   const char *def_filename_;
   Library *lef_library_;
   int def_units_;		// dbu/micron
@@ -137,10 +344,52 @@ protected:
   DefDbu die_ux_;
   DefDbu die_uy_;
   DefPortLocations port_locations_;
-  InstanceDefComponentMap def_component_map_;
+  // Placements are dense so a component costs a few words instead of
+  // a parser object. Slots of deleted instances are reused.
+  DefPlacementSeq placements_;
+  InstancePlacementIndexMap placement_index_;
+  Vector<int> placement_free_;
+  DefComponentExtraSeq component_extras_;
+  // Children of top_instance_ made by makeInstance while
+  // component_names_indexed_.
+  InstanceNameMap component_names_;
+  bool component_names_indexed_;
+  CellPortNameMap cell_port_names_;
   CellLefMacroMap lef_macro_map_;
   LefSiteMap lef_size_map_;
   LefLayerSeq lef_layers_;
+  // Indexed by cell_data_index_ for both the LEF and liberty cells.
+  CellDataSeq cell_data_;
+  CellDataIndexMap cell_data_index_;
+  bool cell_data_valid_;
+  InstanceSpatialIndex inst_index_;
+  PinSpatialIndex port_index_;
+  bool spatial_index_valid_;
+  int edit_epoch_;
+  int design_epoch_;
+};
+
+// Network that liberty files are read into on a thread so the design
+// network is not changed while another thread reads LEF/DEF into it.
+// Reader messages are saved instead of printed. After the thread is
+// joined the libraries are released to LefDefNetwork::addLibertyLibrary.
+class LibertyReadNetwork : public ConcreteNetwork
+{
+public:
+  LibertyReadNetwork(Debug *debug);
+  virtual ~LibertyReadNetwork();
+  // Called by the reader thread.
+  void readLibertyFile(const char *filename,
+		       bool infer_latches);
+  // Messages printed by the reader.
+  const char *messages();
+  // Remove the libraries from this network without deleting them.
+  void releaseLibraries(// Return value.
+			LibertyLibrarySeq &libraries);
+
+protected:
+  Report *read_report_;
+  LibertyLibrarySeq libraries_;
 };
 
 } // namespace
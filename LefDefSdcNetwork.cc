@@ -14,9 +14,12 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <cstring>
 #include "Machine.hh"
 #include "PatternMatch.hh"
 #include "ParseBus.hh"
+#include "LefDefNetwork.hh"
 #include "LefDefSdcNetwork.hh"
 
 namespace sta {
@@ -24,12 +27,102 @@ namespace sta {
 static const char *
 escapeDividers(const char *token,
 	       const Network *network);
+static string
+patternPrefix(const PatternMatch *pattern);
+
+template <class OBJ>
+SdcNameIndex<OBJ>::SdcNameIndex() :
+  epoch_(-1)
+{
+}
+
+template <class OBJ>
+void
+SdcNameIndex<OBJ>::clear(int epoch)
+{
+  names_.clear();
+  epoch_ = epoch;
+}
+
+template <class OBJ>
+void
+SdcNameIndex<OBJ>::insert(const char *sdc_name,
+			  OBJ obj)
+{
+  int order = names_.size();
+  names_.push_back(NameObj{sdc_name, obj, order});
+}
+
+template <class OBJ>
+void
+SdcNameIndex<OBJ>::sort()
+{
+  std::sort(names_.begin(), names_.end(),
+	    [] (const NameObj &name_obj1, const NameObj &name_obj2) {
+	      return name_obj1.name_ < name_obj2.name_;
+	    });
+}
+
+template <class OBJ>
+void
+SdcNameIndex<OBJ>::findMatching(const PatternMatch *pattern,
+				// Return value.
+				Vector<OBJ> *objs) const
+{
+  string prefix = patternPrefix(pattern);
+  auto name_iter = names_.begin();
+  if (!prefix.empty())
+    name_iter = std::lower_bound(names_.begin(), names_.end(), prefix,
+				 [] (const NameObj &name_obj,
+				     const string &prefix) {
+				   return name_obj.name_ < prefix;
+				 });
+  Vector<const NameObj*> matches;
+  for (; name_iter != names_.end(); name_iter++) {
+    const string &name = name_iter->name_;
+    if (name.compare(0, prefix.size(), prefix) != 0)
+      break;
+    if (pattern->match(name.c_str()))
+      matches.push_back(&*name_iter);
+  }
+  // Only the matches are put back in network order.
+  std::sort(matches.begin(), matches.end(),
+	    [] (const NameObj *name_obj1, const NameObj *name_obj2) {
+	      return name_obj1->order_ < name_obj2->order_;
+	    });
+  for (auto match : matches)
+    objs->push_back(match->obj_);
+}
+
+// Characters before the first wildcard. Regular expressions and case
+// insensitive patterns do not have a usable prefix.
+static string
+patternPrefix(const PatternMatch *pattern)
+{
+  if (pattern->isRegexp() || pattern->nocase())
+    return string();
+  const char *pattern_str = pattern->pattern();
+  size_t length = strcspn(pattern_str, "*?[\\");
+  return string(pattern_str, length);
+}
+
+////////////////////////////////////////////////////////////////
 
 LefDefSdcNetwork::LefDefSdcNetwork(Network *network) :
-  SdcNetwork(network)
+  SdcNetwork(network),
+  port_names_epoch_(-1)
 {
 }
 
+void
+LefDefSdcNetwork::clear()
+{
+  instance_index_.clear(-1);
+  net_index_.clear(-1);
+  escaped_port_names_.clear();
+  port_names_epoch_ = -1;
+}
+
 // Override SdcNetwork to NetworkNameAdapter.
 Instance *
 LefDefSdcNetwork::findInstance(const char *path_name) const
@@ -68,13 +161,24 @@ void
 LefDefSdcNetwork::findInstancesMatching1(const PatternMatch *pattern,
 					 InstanceSeq *insts) const
 {
-  InstanceChildIterator *child_iter = childIterator(topInstance());
-  while (child_iter->hasNext()) {
-    Instance *child = child_iter->next();
-    if (pattern->match(staToSdc(name(child))))
-      insts->push_back(child);
+  ensureInstanceIndex();
+  instance_index_.findMatching(pattern, insts);
+}
+
+void
+LefDefSdcNetwork::ensureInstanceIndex() const
+{
+  int epoch = lefDefNetwork()->editEpoch();
+  if (!instance_index_.isValid(epoch)) {
+    instance_index_.clear(epoch);
+    InstanceChildIterator *child_iter = childIterator(topInstance());
+    while (child_iter->hasNext()) {
+      Instance *child = child_iter->next();
+      instance_index_.insert(staToSdc(name(child)), child);
+    }
+    delete child_iter;
+    instance_index_.sort();
   }
-  delete child_iter;
 }
 
 void
@@ -105,13 +209,30 @@ void
 LefDefSdcNetwork::findNetsMatching1(const PatternMatch *pattern,
 				    NetSeq *nets) const
 {
-  NetIterator *net_iter = netIterator(topInstance());
-  while (net_iter->hasNext()) {
-    Net *net = net_iter->next();
-    if (pattern->match(staToSdc(name(net))))
-      nets->push_back(net);
+  ensureNetIndex();
+  net_index_.findMatching(pattern, nets);
+}
+
+void
+LefDefSdcNetwork::ensureNetIndex() const
+{
+  int epoch = lefDefNetwork()->editEpoch();
+  if (!net_index_.isValid(epoch)) {
+    net_index_.clear(epoch);
+    NetIterator *net_iter = netIterator(topInstance());
+    while (net_iter->hasNext()) {
+      Net *net = net_iter->next();
+      net_index_.insert(staToSdc(name(net)), net);
+    }
+    delete net_iter;
+    net_index_.sort();
   }
-  delete net_iter;
+}
+
+const LefDefNetwork *
+LefDefSdcNetwork::lefDefNetwork() const
+{
+  return static_cast<const LefDefNetwork*>(network_);
 }
 
 void
@@ -157,29 +278,21 @@ LefDefSdcNetwork::findMatchingPins(const Instance *instance,
     CellPortIterator *port_iter = network_->portIterator(cell);
     while (port_iter->hasNext()) {
       Port *port = port_iter->next();
-      const char *port_name = network_->name(port);
       if (network_->hasMembers(port)) {
-	bool bus_matches = port_pattern->match(port_name)
-	  || port_pattern->match(escapeDividers(port_name, network_));
+	bool bus_matches = portNameMatches(port, port_pattern);
 	PortMemberIterator *member_iter = network_->memberIterator(port);
 	while (member_iter->hasNext()) {
 	  Port *member_port = member_iter->next();
 	  Pin *pin = network_->findPin(instance, member_port);
 	  if (pin) {
-	    if (bus_matches)
+	    if (bus_matches
+		|| portNameMatches(member_port, port_pattern))
 	      pins->push_back(pin);
-	    else {
-	      const char *member_name = network_->name(member_port);
-	      if (port_pattern->match(member_name)
-		  || port_pattern->match(escapeDividers(member_name, network_)))
-		pins->push_back(pin);
-	    }
 	  }
 	}
 	delete member_iter;
       }
-      else if (port_pattern->match(port_name)
-	       || port_pattern->match(escapeDividers(port_name, network_))) {
+      else if (portNameMatches(port, port_pattern)) {
 	Pin *pin = network_->findPin(instance, port);
 	if (pin)
 	  pins->push_back(pin);
@@ -189,6 +302,38 @@ LefDefSdcNetwork::findMatchingPins(const Instance *instance,
   }
 }
 
+bool
+LefDefSdcNetwork::portNameMatches(const Port *port,
+				  const PatternMatch *port_pattern) const
+{
+  const char *port_name = network_->name(port);
+  const char *escaped = escapedPortName(port);
+  return port_pattern->match(port_name)
+    || (escaped != port_name
+	&& port_pattern->match(escaped));
+}
+
+// Return the port name itself if it does not need escaping.
+const char *
+LefDefSdcNetwork::escapedPortName(const Port *port) const
+{
+  const char *port_name = network_->name(port);
+  int epoch = lefDefNetwork()->editEpoch();
+  if (port_names_epoch_ != epoch) {
+    escaped_port_names_.clear();
+    port_names_epoch_ = epoch;
+  }
+  auto escaped_iter = escaped_port_names_.find(port);
+  if (escaped_iter == escaped_port_names_.end()) {
+    const char *escaped = escapeDividers(port_name, network_);
+    // Names that do not need escaping are cached as empty strings.
+    string cached = stringEq(escaped, port_name) ? string() : string(escaped);
+    escaped_iter = escaped_port_names_.insert({port, cached}).first;
+  }
+  const string &escaped = escaped_iter->second;
+  return escaped.empty() ? port_name : escaped.c_str();
+}
+
 Pin *
 LefDefSdcNetwork::findPin(const char *path_name) const
 {
@@ -17,14 +17,56 @@
 #ifndef RESIZER_LEF_DEF_SDC_NETWORK_H
 #define RESIZER_LEF_DEF_SDC_NETWORK_H
 
+#include <string>
+#include "Vector.hh"
+#include "UnorderedMap.hh"
 #include "SdcNetwork.hh"
 
 namespace sta {
 
+using std::string;
+
+class LefDefNetwork;
+
+// SDC names of the top instance children or nets sorted by name so
+// patterns with a literal prefix only match the names in the range
+// with that prefix. Matches are returned in network iterator order
+// like the unindexed SdcNetwork lookups.
+template <class OBJ>
+class SdcNameIndex
+{
+public:
+  SdcNameIndex();
+  bool isValid(int epoch) const { return epoch_ == epoch; }
+  void clear(int epoch);
+  // Insert in network iterator order.
+  void insert(const char *sdc_name,
+	      OBJ obj);
+  void sort();
+  void findMatching(const PatternMatch *pattern,
+		    // Return value.
+		    Vector<OBJ> *objs) const;
+
+protected:
+  class NameObj
+  {
+  public:
+    string name_;
+    OBJ obj_;
+    // Position in network iterator order.
+    int order_;
+  };
+  Vector<NameObj> names_;
+  // LefDefNetwork::editEpoch when the index was built.
+  int epoch_;
+};
+
 class LefDefSdcNetwork : public SdcNetwork
 {
 public:
   LefDefSdcNetwork(Network *network);
+  // Forget the name indices and escaped port names.
+  void clear();
   virtual Instance *findInstance(const char *path_name) const;
   virtual void findInstancesMatching(const Instance *contex,
 				     const PatternMatch *pattern,
@@ -32,9 +74,9 @@ public:
   virtual void findNetsMatching(const Instance *,
 				const PatternMatch *pattern,
 				NetSeq *nets) const;
-virtual void findPinsMatching(const Instance *instance,
-			      const PatternMatch *pattern,
-			      PinSeq *pins) const;
+  virtual void findPinsMatching(const Instance *instance,
+				const PatternMatch *pattern,
+				PinSeq *pins) const;
 
 protected:
   void findInstancesMatching1(const PatternMatch *pattern,
@@ -45,8 +87,24 @@ protected:
 			const PatternMatch *port_pattern,
 			PinSeq *pins) const;
   Pin *findPin(const char *path_name) const;
+  const LefDefNetwork *lefDefNetwork() const;
+  void ensureInstanceIndex() const;
+  void ensureNetIndex() const;
+  // Port name with path dividers escaped.
+  const char *escapedPortName(const Port *port) const;
+  bool portNameMatches(const Port *port,
+		       const PatternMatch *port_pattern) const;
 
   using SdcNetwork::findPin;
+
+  // Built on the first wildcard query after the network changes.
+  mutable SdcNameIndex<Instance*> instance_index_;
+  mutable SdcNameIndex<Net*> net_index_;
+  // Escaped port names by port. Ports are deleted with their
+  // libraries by LefDefNetwork::clear so the names are only kept
+  // for one edit epoch.
+  mutable UnorderedMap<const Port*, string> escaped_port_names_;
+  mutable int port_names_epoch_;
 };
 
 } // namespace
@@ -63,9 +63,11 @@ class LefReader
 {
 public:
   LefReader(const char *filename,
+	    bool link_liberty,
 	    Library *lef_library,
 	    LefDefNetwork *network);
   const char *filename() { return filename_; }
+  bool linkLiberty() { return link_liberty_; }
   LefDefNetwork *network() { return network_; }
   Library *lefLibrary() { return lef_library_; }
   Cell *lefMacro() { return lef_macro_; }
@@ -73,6 +75,7 @@ public:
 
 private:
   const char *filename_;
+  bool link_liberty_;
   Library *lef_library_;
   LefDefNetwork *network_;
   Cell *lef_macro_;
@@ -86,6 +89,7 @@ LefReader::setLefMacro(Cell *lef_macro)
 
 void
 readLef(const char *filename,
+	bool link_liberty,
 	LefDefNetwork *network)
 {
   lefrInitSession();
@@ -94,7 +98,7 @@ readLef(const char *filename,
   Library *lef_library = network->lefLibrary();
   if (lef_library == nullptr)
     lef_library = network->makeLefLibrary("LEF", filename);
-  LefReader reader(filename, lef_library, network);
+  LefReader reader(filename, link_liberty, lef_library, network);
   FILE *stream = fopen(filename, "r");
   if (stream) {
     lefrRead(stream, filename, &reader);
@@ -118,9 +122,11 @@ registerLefCallbacks()
 }
 
 LefReader::LefReader(const char *filename,
+		     bool link_liberty,
 		     Library *lef_library,
 		     LefDefNetwork *network) :
   filename_(filename),
+  link_liberty_(link_liberty),
   lef_library_(lef_library),
   network_(network),
   lef_macro_(nullptr)
@@ -164,37 +170,8 @@ macroEndCbk(lefrCallbackType_e,
   Cell *cell = reader->lefMacro();
   // Group bus bits into bus ports.
   network->groupBusPorts(cell);
-  // Set corresponding liberty cell and ports for reference by Network.
-  LibertyCell *lib_cell = network->findLibertyCell(network->name(cell));
-  if (lib_cell) {
-    ConcreteCell *ccell = reinterpret_cast<ConcreteCell*>(cell);
-    ccell->setLibertyCell(lib_cell);
-    CellPortIterator *port_iter = network->portIterator(cell);
-    while (port_iter->hasNext()) {
-      Port *port = port_iter->next();
-      const char *port_name = network->name(port);
-      LibertyPort *lib_port = lib_cell->findLibertyPort(port_name);
-      if (lib_port) {
-	ConcretePort *cport = reinterpret_cast<ConcretePort*>(port);
-	cport->setLibertyPort(lib_port);
-
-	if (network->isBus(port)) {
-	  PortMemberIterator *member_iter = network->memberIterator(port);
-	  while (member_iter->hasNext()) {
-	    Port *member = member_iter->next();
-	    const char *member_name = network->name(member);
-	    LibertyPort *member_lport = lib_cell->findLibertyPort(member_name);
-	    if (member_lport) {
-	      ConcretePort *member_cport = reinterpret_cast<ConcretePort*>(member);
-	      member_cport->setLibertyPort(member_lport);
-	    }
-	  }
-	  delete member_iter;
-	}
-      }
-    }
-    delete port_iter;
-  }
+  if (reader->linkLiberty())
+    network->linkLibertyCell(cell);
   reader->setLefMacro(nullptr);
   return 0;
 }
@@ -21,8 +21,12 @@ namespace sta {
 
 class LefDefNetwork;
 
+// With link_liberty false the LEF macros are not linked to liberty
+// cells so liberty files can be read at the same time.
+// Use LefDefNetwork::linkLibertyCells() after both are read.
 void
 readLef(const char *filename,
+	bool link_liberty,
 	LefDefNetwork *network);
 
 } // namespace
@@ -0,0 +1,90 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Machine.hh"
+#include "Error.hh"
+#include "MappedFile.hh"
+
+namespace sta {
+
+// Empty files have no mapping; data() points at an empty string.
+static const char mapped_file_empty[] = "";
+
+MappedFile::MappedFile(const char *filename) :
+  data_(mapped_file_empty),
+  size_(0)
+{
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    throw FileNotReadable(filename);
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == 0
+      && file_stat.st_size > 0) {
+    size_t size = file_stat.st_size;
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      throw FileNotReadable(filename);
+    }
+    data_ = static_cast<const char*>(data);
+    size_ = size;
+    madvise(data, size, MADV_SEQUENTIAL);
+  }
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+  unmap();
+}
+
+// The moved from file is left empty.
+MappedFile::MappedFile(MappedFile &&file) :
+  data_(file.data_),
+  size_(file.size_)
+{
+  file.data_ = mapped_file_empty;
+  file.size_ = 0;
+}
+
+MappedFile &
+MappedFile::operator=(MappedFile &&file)
+{
+  if (this != &file) {
+    unmap();
+    data_ = file.data_;
+    size_ = file.size_;
+    file.data_ = mapped_file_empty;
+    file.size_ = 0;
+  }
+  return *this;
+}
+
+void
+MappedFile::unmap()
+{
+  if (size_ > 0)
+    munmap(const_cast<char*>(data_), size_);
+  data_ = mapped_file_empty;
+  size_ = 0;
+}
+
+} // namespace
@@ -0,0 +1,51 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_MAPPED_FILE_H
+#define RESIZER_MAPPED_FILE_H
+
+#include <cstddef>
+
+namespace sta {
+
+// Read only memory map of a file that is read front to back.
+// Pages are read on demand by the kernel and shared with the page
+// cache, so large files are not copied into the heap.
+// The text is NOT null terminated.
+class MappedFile
+{
+public:
+  // Throws FileNotReadable.
+  explicit MappedFile(const char *filename);
+  ~MappedFile();
+  // The mapping has one owner.
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&file);
+  MappedFile &operator=(MappedFile &&file);
+  const char *data() const { return data_; }
+  const char *end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+
+private:
+  void unmap();
+
+  const char *data_;
+  size_t size_;
+};
+
+} // namespace
+#endif
@@ -0,0 +1,86 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cctype>
+#include <climits>
+#include "Machine.hh"
+#include "StringUtil.hh"
+#include "NameAllocator.hh"
+
+namespace sta {
+
+NameAllocator::NameAllocator(const char *prefix) :
+  prefix_(prefix),
+  next_index_(1)
+{
+}
+
+void
+NameAllocator::setPrefix(const char *prefix)
+{
+  prefix_ = prefix;
+  clear();
+}
+
+void
+NameAllocator::clear()
+{
+  next_index_ = 1;
+}
+
+void
+NameAllocator::noteName(const char *name)
+{
+  size_t prefix_length = prefix_.size();
+  if (prefix_.compare(0, prefix_length, name, 0, prefix_length) == 0) {
+    const char *digits = name + prefix_length;
+    if (*digits) {
+      long index = 0;
+      const char *d;
+      for (d = digits; isdigit(*d) && index <= INT_MAX; d++)
+	index = index * 10 + (*d - '0');
+      // Only names that are the prefix followed by digits can collide.
+      if (*d == '\0'
+	  && index < INT_MAX
+	  && index >= next_index_)
+	next_index_ = index + 1;
+    }
+  }
+}
+
+string
+NameAllocator::makeName()
+{
+  return name(next_index_++);
+}
+
+int
+NameAllocator::reserve(int count)
+{
+  int first = next_index_;
+  next_index_ += count;
+  return first;
+}
+
+string
+NameAllocator::name(int index) const
+{
+  string name;
+  stringPrint(name, "%s%d", prefix_.c_str(), index);
+  return name;
+}
+
+} // namespace
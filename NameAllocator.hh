@@ -0,0 +1,55 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_NAME_ALLOCATOR_H
+#define RESIZER_NAME_ALLOCATOR_H
+
+#include <string>
+
+namespace sta {
+
+using std::string;
+
+// Allocate names of the form <prefix><index>.
+// Existing names are scanned once with noteName so that allocated
+// indices start after the largest index in use, instead of probing
+// the network for every candidate name starting at 1.
+class NameAllocator
+{
+public:
+  explicit NameAllocator(const char *prefix);
+  const char *prefix() const { return prefix_.c_str(); }
+  // Changing the prefix requires the existing names to be noted again.
+  void setPrefix(const char *prefix);
+  // Forget the noted names, for example when a new design is read.
+  void clear();
+  // Note an existing name so its index is not allocated.
+  void noteName(const char *name);
+  string makeName();
+  // Reserve count consecutive indices and return the first one.
+  // Workers can name objects with name(first + i) without sharing
+  // the allocator; the names only depend on the order of the
+  // reservations.
+  int reserve(int count);
+  string name(int index) const;
+
+private:
+  string prefix_;
+  int next_index_;
+};
+
+} // namespace
+#endif
@@ -14,8 +14,15 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include "Machine.hh"
 #include "Report.hh"
+#include "Error.hh"
+#include "StringUtil.hh"
+#include "StringSeq.hh"
 #include "Debug.hh"
 #include "PortDirection.hh"
 #include "TimingRole.hh"
@@ -30,14 +37,19 @@
 #include "GraphDelayCalc.hh"
 #include "Parasitics.hh"
 #include "Sdc.hh"
+#include "Clock.hh"
 #include "PathVertex.hh"
 #include "SearchPred.hh"
 #include "Bfs.hh"
 #include "Search.hh"
 #include "LefDefNetwork.hh"
 #include "LefDefSdcNetwork.hh"
+#include "LefReader.hh"
 #include "DefReader.hh"
+#include "DefWriter.hh"
+#include "DefShard.hh"
 #include "SteinerTree.hh"
+#include "Session.hh"
 #include "Resizer.hh"
 
 // Outstanding issues
@@ -67,15 +79,49 @@ Resizer::Resizer() :
   wire_cap_(0.0),
   corner_(nullptr),
   max_area_(0.0),
-  clk_nets__valid_(false),
+  tile_count_(0),
+  clk_vertices_valid_(false),
+  target_load_map_(nullptr),
   level_drvr_verticies_valid_(false),
-  unique_net_index_(1),
-  unique_buffer_index_(1),
+  edit_batch_depth_(0),
+  edit_batch_network_only_(false),
+  edit_journal_(nullptr),
+  net_names_("net"),
+  buffer_names_("buffer"),
+  names_valid_(false),
+  names_design_epoch_(0),
   core_area_(0.0),
-  design_area_(0.0)
+  design_area_(0.0),
+  session_checkpoint_interval_(0.0)
 {
 }
 
+Resizer::~Resizer()
+{
+  deleteLibraryTables();
+}
+
+LibertyLibrary *
+Resizer::readLiberty(const char *filename,
+		     Corner *corner,
+		     const MinMaxAll *min_max,
+		     bool infer_latches)
+{
+  LibertyLibrary *library = Sta::readLiberty(filename, corner, min_max,
+					     infer_latches);
+  deleteLibraryTables();
+  return library;
+}
+
+void
+Resizer::deleteLibraryTables()
+{
+  gate_table_batches_.deleteContentsClear();
+  delete target_load_map_;
+  target_load_map_ = nullptr;
+  target_load_libs_.clear();
+}
+
 void
 Resizer::makeNetwork()
 {
@@ -103,10 +149,15 @@ Resizer::makeCmdNetwork()
 }
 
 void
-Resizer::readDef(const char *filename)
+Resizer::readDef(const char *filename,
+		 const DefSkip &skip,
+		 bool fast)
 {
   LefDefNetwork *network = lefDefNetwork();
-  sta::readDef(filename, true, network);
+  sta::readDef(filename, true, skip, fast, threadCount(), network);
+  static_cast<LefDefSdcNetwork*>(sdc_network_)->clear();
+  names_valid_ = false;
+  level_drvr_verticies_valid_ = false;
 
   DefDbu die_lx, die_ly, die_ux, die_uy;
   network->dieArea(die_lx, die_ly, die_ux, die_uy);
@@ -118,6 +169,71 @@ Resizer::readDef(const char *filename)
   setCoreSize(lx, ly, ux, uy);
 }
 
+void
+Resizer::readDesignFiles(StringSeq *liberty_files,
+			 const char *lef_filename,
+			 const char *def_filename)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  // The liberty reader thread only touches liberty_network. The
+  // libraries are added to the design network after the join.
+  LibertyReadNetwork liberty_network(debug_);
+  std::exception_ptr liberty_error;
+  std::thread liberty_thread;
+  if (liberty_files && !liberty_files->empty())
+    liberty_thread = std::thread([=, &liberty_network, &liberty_error]() {
+	try {
+	  for (const char *filename : *liberty_files)
+	    liberty_network.readLibertyFile(filename, false);
+	}
+	catch (...) {
+	  liberty_error = std::current_exception();
+	}
+      });
+
+  std::exception_ptr lef_def_error;
+  try {
+    if (lef_filename)
+      readLef(lef_filename, false, network);
+    if (def_filename)
+      readDef(def_filename, DefSkip(), false);
+  }
+  catch (...) {
+    lef_def_error = std::current_exception();
+  }
+
+  if (liberty_thread.joinable())
+    liberty_thread.join();
+  report_->print("%s", liberty_network.messages());
+  LibertyLibrarySeq libraries;
+  liberty_network.releaseLibraries(libraries);
+  // Libraries are added in file order like sequential reads.
+  for (auto library : libraries)
+    addLibertyLibrary(library);
+  if (liberty_error)
+    std::rethrow_exception(liberty_error);
+  if (lef_def_error)
+    std::rethrow_exception(lef_def_error);
+  network->linkLibertyCells();
+}
+
+// The design network part of Sta::readLiberty for a library read by a
+// LibertyReadNetwork.
+void
+Resizer::addLibertyLibrary(LibertyLibrary *library)
+{
+  lefDefNetwork()->addLibertyLibrary(library);
+  readLibertyAfter(library, cmd_corner_, MinMax::min());
+  readLibertyAfter(library, cmd_corner_, MinMax::max());
+  // The default library is the first library read.
+  if (network_->defaultLibertyLibrary() == nullptr) {
+    network_->setDefaultLibertyLibrary(library);
+    // Set units from default (first) library.
+    *units_ = *library->units();
+  }
+  deleteLibraryTables();
+}
+
 ////////////////////////////////////////////////////////////////
 
 double
@@ -243,7 +359,7 @@ Resizer::init()
 {
   ensureLevelized();
   ensureLevelDrvrVerticies();
-  ensureClkNets();
+  ensureClkVertices();
   ensureCorner();
 }
 
@@ -279,11 +395,15 @@ Resizer::initCorner(Corner *corner)
   dcalc_ap_ = corner->findDcalcAnalysisPt(min_max_);
   pvt_ = dcalc_ap_->operatingConditions();
   parasitics_ap_ = corner->findParasiticAnalysisPt(min_max_);
+  // Table samples and target loads include pvt scale factors.
+  gate_table_batches_.deleteContentsClear();
+  target_load_libs_.clear();
 }
 
 void
 Resizer::ensureLevelDrvrVerticies()
 {
+  ensureLevelized();
   if (!level_drvr_verticies_valid_) {
     level_drvr_verticies_.clear();
     VertexIterator vertex_iter(graph_);
@@ -293,8 +413,106 @@ Resizer::ensureLevelDrvrVerticies()
 	level_drvr_verticies_.push_back(vertex);
     }
     sort(level_drvr_verticies_, VertexLevelLess(network_));
+    level_drvr_pending_.clear();
+    level_drvr_removed_.clear();
+    recordLevelDrvrLevels();
     level_drvr_verticies_valid_ = true;
   }
+  else
+    updateLevelDrvrVerticies();
+}
+
+// Drivers whose level changed since the list was sorted (the fanout of
+// inserted buffers) are taken out and merged back in with the new
+// drivers, so only they are sorted instead of the whole list.
+void
+Resizer::updateLevelDrvrVerticies()
+{
+  VertexSeq changed = level_drvr_pending_;
+  size_t count = 0;
+  for (size_t i = 0; i < level_drvr_verticies_.size(); i++) {
+    Vertex *vertex = level_drvr_verticies_[i];
+    if (!level_drvr_removed_.hasKey(vertex)) {
+      if (vertex->level() == level_drvr_levels_[i])
+	level_drvr_verticies_[count++] = vertex;
+      else
+	changed.push_back(vertex);
+    }
+  }
+  level_drvr_verticies_.resize(count);
+  level_drvr_pending_.clear();
+  level_drvr_removed_.clear();
+
+  if (!changed.empty()) {
+    VertexLevelLess level_less(network_);
+    sort(changed, level_less);
+    VertexSeq merged;
+    merged.reserve(count + changed.size());
+    auto begin = level_drvr_verticies_.begin();
+    auto end = level_drvr_verticies_.end();
+    for (auto vertex : changed) {
+      auto pos = std::upper_bound(begin, end, vertex, level_less);
+      merged.insert(merged.end(), begin, pos);
+      merged.push_back(vertex);
+      begin = pos;
+    }
+    merged.insert(merged.end(), begin, end);
+    level_drvr_verticies_.swap(merged);
+    debugPrint1(debug_, "resizer", 2, "merged %d level drivers\n",
+		static_cast<int>(changed.size()));
+  }
+  recordLevelDrvrLevels();
+}
+
+void
+Resizer::recordLevelDrvrLevels()
+{
+  level_drvr_levels_.resize(level_drvr_verticies_.size());
+  for (size_t i = 0; i < level_drvr_verticies_.size(); i++)
+    level_drvr_levels_[i] = level_drvr_verticies_[i]->level();
+}
+
+// Call after the instance pins are connected.
+void
+Resizer::addLevelDrvrs(const Instance *inst)
+{
+  // Nothing to update until the list is built. Network only edit
+  // batches rebuild the list when they are committed.
+  if (!level_drvr_verticies_valid_
+      || edit_batch_network_only_)
+    return;
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    Vertex *vertex = graph_->pinDrvrVertex(pin);
+    if (vertex && vertex->isDriver(network_))
+      level_drvr_pending_.push_back(vertex);
+  }
+  delete pin_iter;
+}
+
+// Call before the instance is deleted.
+void
+Resizer::removeLevelDrvrs(const Instance *inst)
+{
+  if (!level_drvr_verticies_valid_
+      || edit_batch_network_only_)
+    return;
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    Vertex *vertex = graph_->pinDrvrVertex(pin);
+    if (vertex) {
+      auto pending = std::find(level_drvr_pending_.begin(),
+			       level_drvr_pending_.end(),
+			       vertex);
+      if (pending == level_drvr_pending_.end())
+	level_drvr_removed_.insert(vertex);
+      else
+	level_drvr_pending_.erase(pending);
+    }
+  }
+  delete pin_iter;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -305,14 +523,498 @@ Resizer::resizePreamble(LibertyLibrarySeq *resize_libs)
   init();
   makeEquivCells(resize_libs);
   findTargetLoads(resize_libs);
+  // Resizing and buffering keep the design area up to date from here.
+  design_area_ = lefDefNetwork()->designArea();
+}
+
+////////////////////////////////////////////////////////////////
+
+// Inverse of one network edit.
+class EditJournalEntry
+{
+public:
+  enum class Type { make_instance, make_net, connect, disconnect,
+		    replace_cell, set_location };
+
+  Type type_;
+  Instance *inst_;
+  Port *port_;
+  Net *net_;
+  // Cell before replace_cell.
+  Cell *cell_;
+  // Location before set_location.
+  DefPt location_;
+};
+
+// Network edits made since Resizer::checkpointEdits and the resizer
+// state at the checkpoint.
+class EditJournal
+{
+public:
+  EditJournal(double design_area,
+	      int inserted_buffer_count,
+	      int rebuffer_net_count,
+	      int resize_count,
+	      const NameAllocator &buffer_names,
+	      const NameAllocator &net_names,
+	      bool names_valid);
+  double designArea() const { return design_area_; }
+  int insertedBufferCount() const { return inserted_buffer_count_; }
+  int rebufferNetCount() const { return rebuffer_net_count_; }
+  int resizeCount() const { return resize_count_; }
+  const NameAllocator &bufferNames() const { return buffer_names_; }
+  const NameAllocator &netNames() const { return net_names_; }
+  bool namesValid() const { return names_valid_; }
+  const EditJournalEntrySeq &entries() const { return entries_; }
+  void makeInstance(Instance *inst);
+  void makeNet(Net *net);
+  void connect(Instance *inst,
+	       Port *port);
+  void disconnect(Instance *inst,
+		  Port *port,
+		  Net *net);
+  void replaceCell(Instance *inst,
+		   Cell *prev_cell);
+  void setLocation(Instance *inst,
+		   DefPt prev_location);
+
+private:
+  void record(EditJournalEntry::Type type,
+	      Instance *inst,
+	      Port *port,
+	      Net *net,
+	      Cell *cell,
+	      DefPt location);
+
+  double design_area_;
+  int inserted_buffer_count_;
+  int rebuffer_net_count_;
+  int resize_count_;
+  NameAllocator buffer_names_;
+  NameAllocator net_names_;
+  bool names_valid_;
+  EditJournalEntrySeq entries_;
+};
+
+EditJournal::EditJournal(double design_area,
+			 int inserted_buffer_count,
+			 int rebuffer_net_count,
+			 int resize_count,
+			 const NameAllocator &buffer_names,
+			 const NameAllocator &net_names,
+			 bool names_valid) :
+  design_area_(design_area),
+  inserted_buffer_count_(inserted_buffer_count),
+  rebuffer_net_count_(rebuffer_net_count),
+  resize_count_(resize_count),
+  buffer_names_(buffer_names),
+  net_names_(net_names),
+  names_valid_(names_valid)
+{
+}
+
+void
+EditJournal::record(EditJournalEntry::Type type,
+		    Instance *inst,
+		    Port *port,
+		    Net *net,
+		    Cell *cell,
+		    DefPt location)
+{
+  entries_.push_back(EditJournalEntry{type, inst, port, net, cell, location});
+}
+
+void
+EditJournal::makeInstance(Instance *inst)
+{
+  record(EditJournalEntry::Type::make_instance,
+	 inst, nullptr, nullptr, nullptr, DefPt());
+}
+
+void
+EditJournal::makeNet(Net *net)
+{
+  record(EditJournalEntry::Type::make_net,
+	 nullptr, nullptr, net, nullptr, DefPt());
+}
+
+void
+EditJournal::connect(Instance *inst,
+		     Port *port)
+{
+  record(EditJournalEntry::Type::connect,
+	 inst, port, nullptr, nullptr, DefPt());
+}
+
+void
+EditJournal::disconnect(Instance *inst,
+			Port *port,
+			Net *net)
+{
+  record(EditJournalEntry::Type::disconnect,
+	 inst, port, net, nullptr, DefPt());
+}
+
+void
+EditJournal::replaceCell(Instance *inst,
+			 Cell *prev_cell)
+{
+  record(EditJournalEntry::Type::replace_cell,
+	 inst, nullptr, nullptr, prev_cell, DefPt());
+}
+
+void
+EditJournal::setLocation(Instance *inst,
+			 DefPt prev_location)
+{
+  record(EditJournalEntry::Type::set_location,
+	 inst, nullptr, nullptr, nullptr, prev_location);
+}
+
+////////////////////////////////////////////////////////////////
+
+// Batches with fewer edits than this always update the graph
+// incrementally.
+static const int edit_batch_incremental_max = 1000;
+// Rebuilding the graph costs about as much as incrementally editing
+// this many pins per instance in the design.
+static const float edit_batch_rebuild_ratio = 0.5;
+
+void
+Resizer::beginEditBatch(int edit_count)
+{
+  if (edit_batch_depth_++ == 0) {
+    // The mode is fixed for the whole batch so the graph is either
+    // up to date at every edit or not used until the commit.
+    float rebuild_count = max(static_cast<float>(edit_batch_incremental_max),
+			      network_->instanceCount()
+			      * edit_batch_rebuild_ratio);
+    edit_batch_network_only_ = graph_
+      && edit_count > rebuild_count;
+    debugPrint2(debug_, "resizer", 1, "edit batch %d edits%s\n",
+		edit_count,
+		edit_batch_network_only_ ? " network only" : "");
+  }
+}
+
+void
+Resizer::commitEditBatch()
+{
+  if (edit_batch_depth_ > 0
+      && --edit_batch_depth_ == 0) {
+    bool network_only = edit_batch_network_only_;
+    if (network_only) {
+      edit_batch_network_only_ = false;
+      // Rebuild the graph and everything that refers to its vertices.
+      bool level_drvrs_valid = level_drvr_verticies_valid_;
+      networkChanged();
+      ensureGraph();
+      level_drvr_verticies_valid_ = false;
+      level_drvr_pending_.clear();
+      level_drvr_removed_.clear();
+      clk_vertices_valid_ = false;
+      ensureClkVertices();
+      if (level_drvrs_valid)
+	ensureLevelDrvrVerticies();
+    }
+    if (wire_res_ != 0.0 || wire_cap_ != 0.0) {
+      ensureCorner();
+      if (network_only)
+	// The rebuilt graph has no parasitic delays.
+	makeNetParasitics();
+      else {
+	for (auto net : edit_batch_nets_) {
+	  if (!isClock(net))
+	    makeNetParasitics(net);
+	}
+      }
+    }
+    edit_batch_nets_.clear();
+  }
+}
+
+// Return true if the edit should only change the network.
+bool
+Resizer::editNetworkOnly()
+{
+  return edit_batch_network_only_;
+}
+
+// Note a net whose parasitics are estimated again by commitEditBatch.
+void
+Resizer::editTouchNet(Net *net)
+{
+  if (edit_batch_depth_ > 0 && net)
+    edit_batch_nets_.insert(net);
+}
+
+// Replacing the cell or moving the instance moves its pins.
+void
+Resizer::editTouchNets(const Instance *inst)
+{
+  if (edit_batch_depth_ > 0) {
+    InstancePinIterator *pin_iter = network_->pinIterator(inst);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      editTouchNet(network_->net(pin));
+    }
+    delete pin_iter;
+  }
+}
+
+Instance *
+Resizer::editMakeInstance(Cell *cell,
+			  const char *name,
+			  Instance *parent)
+{
+  Instance *inst = lefDefNetwork()->makeInstance(cell, name, parent);
+  if (edit_journal_)
+    edit_journal_->makeInstance(inst);
+  return inst;
+}
+
+Instance *
+Resizer::editMakeInstance(LibertyCell *cell,
+			  const char *name,
+			  Instance *parent)
+{
+  Instance *inst = lefDefNetwork()->makeInstance(cell, name, parent);
+  if (edit_journal_)
+    edit_journal_->makeInstance(inst);
+  return inst;
+}
+
+Net *
+Resizer::editMakeNet(const char *name,
+		     Instance *parent)
+{
+  Net *net = lefDefNetwork()->makeNet(name, parent);
+  if (edit_journal_)
+    edit_journal_->makeNet(net);
+  return net;
+}
+
+void
+Resizer::editSetLocation(Instance *inst,
+			 DefPt location)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  if (edit_journal_) {
+    const DefPlacement *placement = network->placement(inst);
+    if (placement && placement->isPlaced())
+      edit_journal_->setLocation(inst, placement->location());
+  }
+  network->setLocation(inst, location);
+  editTouchNets(inst);
+}
+
+void
+Resizer::editConnectPin(Instance *inst,
+			Port *port,
+			Net *net)
+{
+  if (editNetworkOnly())
+    lefDefNetwork()->connect(inst, port, net);
+  else
+    connectPin(inst, port, net);
+  editTouchNet(net);
+  if (edit_journal_)
+    edit_journal_->connect(inst, port);
+}
+
+void
+Resizer::editConnectPin(Instance *inst,
+			LibertyPort *port,
+			Net *net)
+{
+  if (editNetworkOnly())
+    lefDefNetwork()->connect(inst, port, net);
+  else
+    connectPin(inst, port, net);
+  editTouchNet(net);
+  if (edit_journal_) {
+    Pin *pin = network_->findPin(inst, port->name());
+    edit_journal_->connect(inst, network_->port(pin));
+  }
+}
+
+void
+Resizer::editDisconnectPin(Pin *pin)
+{
+  if (edit_journal_)
+    edit_journal_->disconnect(network_->instance(pin),
+			      network_->port(pin),
+			      network_->net(pin));
+  editTouchNet(network_->net(pin));
+  if (editNetworkOnly())
+    lefDefNetwork()->disconnectPin(pin);
+  else
+    disconnectPin(pin);
+}
+
+void
+Resizer::editReplaceCell(Instance *inst,
+			 Cell *cell)
+{
+  if (edit_journal_)
+    edit_journal_->replaceCell(inst, network_->cell(inst));
+  if (editNetworkOnly())
+    lefDefNetwork()->replaceCell(inst, cell);
+  else
+    replaceCell(inst, cell);
+  editTouchNets(inst);
+}
+
+void
+Resizer::editDeleteInstance(Instance *inst)
+{
+  if (edit_journal_) {
+    // Deleted instances cannot be restored with the same identity.
+    report_->warn("instance deleted; edit checkpoint discarded.\n");
+    acceptEdits();
+  }
+  editTouchNets(inst);
+  if (editNetworkOnly())
+    lefDefNetwork()->deleteInstance(inst);
+  else {
+    clearClock(inst);
+    deleteInstance(inst);
+  }
+}
+
+void
+Resizer::editDeleteNet(Net *net)
+{
+  edit_batch_nets_.erase(net);
+  if (editNetworkOnly())
+    lefDefNetwork()->deleteNet(net);
+  else
+    deleteNet(net);
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+Resizer::checkpointEdits()
+{
+  delete edit_journal_;
+  edit_journal_ = new EditJournal(design_area_,
+				  inserted_buffer_count_,
+				  rebuffer_net_count_,
+				  resize_count_,
+				  buffer_names_,
+				  net_names_,
+				  names_valid_);
+}
+
+void
+Resizer::acceptEdits()
+{
+  delete edit_journal_;
+  edit_journal_ = nullptr;
+}
+
+bool
+Resizer::haveEditCheckpoint() const
+{
+  return edit_journal_ != nullptr;
+}
+
+// Undo the journal entries in reverse order. The journal is detached
+// first so the inverse edits are not recorded.
+void
+Resizer::rollbackEdits()
+{
+  EditJournal *journal = edit_journal_;
+  edit_journal_ = nullptr;
+  if (journal) {
+    const EditJournalEntrySeq &entries = journal->entries();
+    // The batch estimates the parasitics of the changed nets.
+    beginEditBatch(entries.size());
+    for (auto entry_iter = entries.rbegin();
+	 entry_iter != entries.rend();
+	 entry_iter++) {
+      const EditJournalEntry &entry = *entry_iter;
+      switch (entry.type_) {
+      case EditJournalEntry::Type::make_instance:
+	removeLevelDrvrs(entry.inst_);
+	editDeleteInstance(entry.inst_);
+	break;
+      case EditJournalEntry::Type::make_net:
+	if (parasitics_ap_)
+	  parasitics_->deleteParasitics(entry.net_, parasitics_ap_);
+	editDeleteNet(entry.net_);
+	break;
+      case EditJournalEntry::Type::connect: {
+	Pin *pin = network_->findPin(entry.inst_, entry.port_);
+	if (pin)
+	  editDisconnectPin(pin);
+	break;
+      }
+      case EditJournalEntry::Type::disconnect:
+	editConnectPin(entry.inst_, entry.port_, entry.net_);
+	break;
+      case EditJournalEntry::Type::replace_cell:
+	editReplaceCell(entry.inst_, entry.cell_);
+	break;
+      case EditJournalEntry::Type::set_location:
+	editSetLocation(entry.inst_, entry.location_);
+	break;
+      }
+    }
+    commitEditBatch();
+    report_->print("Rolled back %d edits.\n",
+		   static_cast<int>(entries.size()));
+    design_area_ = journal->designArea();
+    inserted_buffer_count_ = journal->insertedBufferCount();
+    rebuffer_net_count_ = journal->rebufferNetCount();
+    resize_count_ = journal->resizeCount();
+    // The names allocated since the checkpoint are free again.
+    buffer_names_ = journal->bufferNames();
+    net_names_ = journal->netNames();
+    names_valid_ = journal->namesValid();
+    delete journal;
+
+    // Clock vertex ids of deleted buffers may be reused.
+    level_drvr_verticies_valid_ = false;
+    clk_vertices_valid_ = false;
+    ensureClkVertices();
+  }
 }
 
 ////////////////////////////////////////////////////////////////
 
+// Pin connects and disconnects made by buffering the top level
+// input or output ports.
+int
+Resizer::bufferPortsEditCount(bool inputs)
+{
+  int edit_count = 0;
+  InstancePinIterator *port_iter(network_->pinIterator(network_->topInstance()));
+  while (port_iter->hasNext()) {
+    Pin *pin = port_iter->next();
+    PortDirection *dir = network_->direction(pin);
+    Net *net = network_->net(network_->term(pin));
+    if (net
+	&& (inputs ? dir->isInput() : dir->isOutput())) {
+      NetPinIterator *pin_iter = network_->pinIterator(net);
+      while (pin_iter->hasNext()) {
+	pin_iter->next();
+	edit_count += 2;
+      }
+      delete pin_iter;
+      edit_count += 2;
+    }
+  }
+  delete port_iter;
+  return edit_count;
+}
+
 void
 Resizer::bufferInputs(LibertyCell *buffer_cell)
 {
   inserted_buffer_count_ = 0;
+  beginEditBatch(bufferPortsEditCount(true));
   InstancePinIterator *port_iter(network_->pinIterator(network_->topInstance()));
   while (port_iter->hasNext()) {
     Pin *pin = port_iter->next();
@@ -322,6 +1024,7 @@ Resizer::bufferInputs(LibertyCell *buffer_cell)
       bufferInput(pin, buffer_cell);
   }
   delete port_iter;
+  commitEditBatch();
   report_->print("Inserted %d input buffers.\n",
 		 inserted_buffer_count_);
 }
@@ -338,27 +1041,31 @@ Resizer::bufferInput(Pin *top_pin,
   string buffer_out_net_name = makeUniqueNetName();
   string buffer_name = makeUniqueBufferName();
   Instance *parent = network->topInstance();
-  Net *buffer_out = network->makeNet(buffer_out_net_name.c_str(), parent);
-  Instance *buffer = network->makeInstance(buffer_cell,
-					   buffer_name.c_str(),
-					   parent);
-  network->setLocation(buffer, network->location(top_pin));
+  Net *buffer_out = editMakeNet(buffer_out_net_name.c_str(), parent);
+  Instance *buffer = editMakeInstance(buffer_cell,
+				      buffer_name.c_str(),
+				      parent);
+  editSetLocation(buffer, network->location(top_pin));
   inserted_buffer_count_++;
+  design_area_ += network->area(buffer);
 
   NetPinIterator *pin_iter(network->pinIterator(input_net));
   while (pin_iter->hasNext()) {
     Pin *pin = pin_iter->next();
-    disconnectPin(pin);
-    connectPin(network->instance(pin), network->port(pin), buffer_out);
+    editDisconnectPin(pin);
+    editConnectPin(network->instance(pin), network->port(pin), buffer_out);
   }
-  connectPin(buffer, input, input_net);
-  connectPin(buffer, output, buffer_out);
+  editConnectPin(buffer, input, input_net);
+  editConnectPin(buffer, output, buffer_out);
+  updateBufferClock(buffer, input_net);
+  addLevelDrvrs(buffer);
 }
 
 void
 Resizer::bufferOutputs(LibertyCell *buffer_cell)
 {
   inserted_buffer_count_ = 0;
+  beginEditBatch(bufferPortsEditCount(false));
   InstancePinIterator *port_iter(network_->pinIterator(network_->topInstance()));
   while (port_iter->hasNext()) {
     Pin *pin = port_iter->next();
@@ -366,6 +1073,7 @@ Resizer::bufferOutputs(LibertyCell *buffer_cell)
       bufferOutput(pin, buffer_cell);
   }
   delete port_iter;
+  commitEditBatch();
   report_->print("Inserted %d output buffers.\n",
 		 inserted_buffer_count_);
 }
@@ -382,41 +1090,120 @@ Resizer::bufferOutput(Pin *top_pin,
   string buffer_in_net_name = makeUniqueNetName();
   string buffer_name = makeUniqueBufferName();
   Instance *parent = network->topInstance();
-  Net *buffer_in = network->makeNet(buffer_in_net_name.c_str(), parent);
-  Instance *buffer = network->makeInstance(buffer_cell,
-					   buffer_name.c_str(),
-					   parent);
-  network->setLocation(buffer, network->location(top_pin));
+  Net *buffer_in = editMakeNet(buffer_in_net_name.c_str(), parent);
+  Instance *buffer = editMakeInstance(buffer_cell,
+				      buffer_name.c_str(),
+				      parent);
+  editSetLocation(buffer, network->location(top_pin));
   inserted_buffer_count_++;
+  design_area_ += network->area(buffer);
 
   NetPinIterator *pin_iter(network->pinIterator(output_net));
   while (pin_iter->hasNext()) {
     Pin *pin = pin_iter->next();
-    disconnectPin(pin);
-    connectPin(network->instance(pin), network->port(pin), buffer_in);
+    editDisconnectPin(pin);
+    editConnectPin(network->instance(pin), network->port(pin), buffer_in);
   }
-  connectPin(buffer, input, buffer_in);
-  connectPin(buffer, output, output_net);
+  editConnectPin(buffer, input, buffer_in);
+  editConnectPin(buffer, output, output_net);
+  updateBufferClock(buffer, output_net);
+  addLevelDrvrs(buffer);
 }
 
 ////////////////////////////////////////////////////////////////
 
 void
-Resizer::resizeToTargetSlew()
+Resizer::resizeToTargetSlew(int max_iterations)
 {
   resize_count_ = 0;
-  // Resize in reverse level order.
-  for (int i = level_drvr_verticies_.size() - 1; i >= 0; i--) {
-    Vertex *vertex = level_drvr_verticies_[i];
-    Pin *drvr_pin = vertex->pin();
-    Instance *inst = network_->instance(drvr_pin);
-    resizeToTargetSlew(inst);
-    if (overMaxArea()) {
-      report_->warn("max utilization reached.\n");
-      break;
+  ensureLevelDrvrVerticies();
+  VertexSeq drvrs = level_drvr_verticies_;
+  VertexSet requeued;
+  int iteration = 0;
+  bool over_max_area = false;
+  while (!drvrs.empty()
+	 && iteration < max_iterations
+	 && !over_max_area) {
+    // The load caps are found with the graph so it is updated
+    // incrementally. The nets of the resized instances get new
+    // parasitics when the pass is committed.
+    beginEditBatch();
+    if (useTiles()) {
+      // Resize in reverse level order one level at a time.
+      int i = drvrs.size() - 1;
+      while (i >= 0 && !over_max_area) {
+	Level level = drvrs[i]->level();
+	VertexSeq level_drvrs;
+	for (; i >= 0 && drvrs[i]->level() == level; i--)
+	  level_drvrs.push_back(drvrs[i]);
+	over_max_area = resizeLevelTiles(level_drvrs, requeued);
+      }
+    }
+    else {
+      // Resize in reverse level order.
+      for (int i = drvrs.size() - 1; i >= 0; i--) {
+	Vertex *vertex = drvrs[i];
+	Pin *drvr_pin = vertex->pin();
+	Instance *inst = network_->instance(drvr_pin);
+	if (resizeToTargetSlew(inst))
+	  // The instance input pin caps changed so the fanin drivers
+	  // see a different load.
+	  findFaninDrvrs(inst, requeued);
+	if (overMaxArea()) {
+	  report_->warn("max utilization reached.\n");
+	  over_max_area = true;
+	  break;
+	}
+      }
+    }
+    commitEditBatch();
+    iteration++;
+    debugPrint2(debug_, "resizer", 1, "iteration %d requeued %d drivers\n",
+		iteration,
+		static_cast<int>(requeued.size()));
+    drvrs.clear();
+    for (auto drvr : requeued)
+      drvrs.push_back(drvr);
+    requeued.clear();
+    // Resizing does not change levels so the next pass does not need
+    // to relevelize.
+    sort(drvrs, VertexLevelLess(network_));
+    writeSessionCheckpoint();
+  }
+  if (max_iterations > 1)
+    report_->print("Resized %d instances in %d iterations.\n",
+		   resize_count_,
+		   iteration);
+  else
+    report_->print("Resized %d instances.\n", resize_count_);
+}
+
+void
+Resizer::findFaninDrvrs(const Instance *inst,
+			// Return value.
+			VertexSet &drvrs)
+{
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (network_->direction(pin)->isAnyInput()) {
+      Net *net = network_->net(pin);
+      if (net) {
+	PinSet *net_drvrs = network_->drivers(net);
+	if (net_drvrs) {
+	  PinSet::Iterator drvr_iter(net_drvrs);
+	  while (drvr_iter.hasNext()) {
+	    Pin *drvr = drvr_iter.next();
+	    Vertex *drvr_vertex = graph_->pinDrvrVertex(drvr);
+	    if (drvr_vertex
+		&& !network_->isTopLevelPort(drvr))
+	      drvrs.insert(drvr_vertex);
+	  }
+	}
+      }
     }
   }
-  report_->print("Resized %d instances.\n", resize_count_);
+  delete pin_iter;
 }
 
 void
@@ -433,60 +1220,175 @@ Resizer::makeEquivCells(LibertyLibrarySeq *resize_libs)
   makeEquivCells(resize_libs, &map_libs);
 }
 
-void
+bool
 Resizer::resizeToTargetSlew(Instance *inst)
 {
-  LefDefNetwork *network = lefDefNetwork();
   LibertyCell *cell = network_->libertyCell(inst);
   if (cell) {
     Pin *output = singleOutputPin(inst, network_);
     // Only resize single output gates for now.
     if (output) {
-      Net *out_net = network->net(output);
       // Hands off the clock nets.
-      if (!isClock(out_net)) {
+      if (!isClock(graph_->pinDrvrVertex(output))) {
 	// Includes net parasitic capacitance.
 	float load_cap = graph_delay_calc_->loadCap(output, dcalc_ap_);
-	LibertyCell *best_cell = nullptr;
-	float best_ratio = 0.0;
-	auto equiv_cells = equivCells(cell);
-	if (equiv_cells) {
-	  for (auto target_cell : *equiv_cells) {
-	    if (!dontUse(target_cell)) {
-	      float target_load = (*target_load_map_)[target_cell];
-	      float ratio = target_load / load_cap;
-	      if (ratio > 1.0)
-		ratio = 1.0 / ratio;
-	      if (ratio > best_ratio) {
-		best_ratio = ratio;
-		best_cell = target_cell;
-	      }
-	    }
-	  }
-	  if (best_cell && best_cell != cell) {
-	    debugPrint3(debug_, "resizer", 2, "%s %s -> %s\n",
-			sdc_network_->pathName(inst),
-			cell->name(),
-			best_cell->name());
-	    if (network->isLefCell(network_->cell(inst))) {
-	      // Replace LEF with LEF so ports stay aligned in instance.
-	      Cell *best_lef = network->lefCell(best_cell);
-	      if (best_lef) {
-		design_area_ -= network->area(inst);
-		replaceCell(inst, best_lef);
-		resize_count_++;
-		design_area_ += network->area(inst);
-	      }
-	    }
-	    else {
-	      replaceCell(inst, best_cell);
-	      resize_count_++;
-	    }
-	  }
+	LibertyCell *best_cell = findTargetCell(cell, load_cap);
+	if (best_cell && best_cell != cell)
+	  return resizeInstance(inst, best_cell);
+      }
+    }
+  }
+  return false;
+}
+
+// Return the equivalent cell with the target load closest to load_cap.
+// Only reads the equivalent cells and target loads so it can be called
+// concurrently.
+LibertyCell *
+Resizer::findTargetCell(LibertyCell *cell,
+			float load_cap)
+{
+  LibertyCell *best_cell = nullptr;
+  float best_ratio = 0.0;
+  auto equiv_cells = equivCells(cell);
+  if (equiv_cells) {
+    for (auto target_cell : *equiv_cells) {
+      if (!dontUse(target_cell)) {
+	float target_load = targetLoadCap(target_cell);
+	float ratio = target_load / load_cap;
+	if (ratio > 1.0)
+	  ratio = 1.0 / ratio;
+	if (ratio > best_ratio) {
+	  best_ratio = ratio;
+	  best_cell = target_cell;
 	}
       }
     }
   }
+  return best_cell;
+}
+
+class TileResize
+{
+public:
+  TileResize(Instance *inst,
+	     LibertyCell *cell,
+	     float load_cap);
+
+  Instance *inst_;
+  LibertyCell *cell_;
+  float load_cap_;
+  LibertyCell *target_cell_;
+};
+
+TileResize::TileResize(Instance *inst,
+		       LibertyCell *cell,
+		       float load_cap) :
+  inst_(inst),
+  cell_(cell),
+  load_cap_(load_cap),
+  target_cell_(nullptr)
+{
+}
+
+typedef Vector<TileResize> TileResizeSeq;
+
+// Smaller levels are not worth the thread startup.
+static const size_t tile_thread_net_min = 16;
+
+// Drivers at the same level are not in each other's fanin, so the
+// target cells for a level only depend on the loads found before any of
+// them are resized, the same as resizing them one at a time.
+// Load caps are found serially because the delay calculator caches
+// reduced parasitics. The target cells of the drivers of nets inside a
+// tile are found by the worker threads, then the target cells of the
+// nets that cross tiles in one serial pass. The cells are replaced
+// serially in tile order followed by the nets that cross tiles.
+// Return true if the max utilization is reached.
+bool
+Resizer::resizeLevelTiles(const VertexSeq &drvrs,
+			  // Return value.
+			  VertexSet &requeued)
+{
+  Vector<TileResizeSeq> tile_resizes(tile_count_ * tile_count_);
+  TileResizeSeq boundary_resizes;
+  size_t tile_resize_count = 0;
+  for (auto vertex : drvrs) {
+    Instance *inst = network_->instance(vertex->pin());
+    LibertyCell *cell = network_->libertyCell(inst);
+    if (cell) {
+      Pin *output = singleOutputPin(inst, network_);
+      // Only resize single output gates for now.
+      // Hands off the clock nets.
+      if (output
+	  && !isClock(graph_->pinDrvrVertex(output))) {
+	float load_cap = graph_delay_calc_->loadCap(output, dcalc_ap_);
+	int tile = netTile(network_->net(output));
+	if (tile >= 0) {
+	  tile_resizes[tile].push_back(TileResize(inst, cell, load_cap));
+	  tile_resize_count++;
+	}
+	else
+	  boundary_resizes.push_back(TileResize(inst, cell, load_cap));
+      }
+    }
+  }
+  forEachTile(tile_resize_count >= tile_thread_net_min, [&] (int tile) {
+      for (auto &resize : tile_resizes[tile])
+	resize.target_cell_ = findTargetCell(resize.cell_, resize.load_cap_);
+    });
+  for (auto &resize : boundary_resizes)
+    resize.target_cell_ = findTargetCell(resize.cell_, resize.load_cap_);
+  debugPrint2(debug_, "resizer", 1, "level %d boundary drivers %d\n",
+	      drvrs.empty() ? 0 : drvrs[0]->level(),
+	      static_cast<int>(boundary_resizes.size()));
+
+  tile_resizes.push_back(boundary_resizes);
+  for (auto &resizes : tile_resizes) {
+    for (auto &resize : resizes) {
+      if (resize.target_cell_
+	  && resize.target_cell_ != resize.cell_
+	  && resizeInstance(resize.inst_, resize.target_cell_))
+	// The instance input pin caps changed so the fanin drivers
+	// see a different load.
+	findFaninDrvrs(resize.inst_, requeued);
+      if (overMaxArea()) {
+	report_->warn("max utilization reached.\n");
+	return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Return true if the instance cell was changed.
+bool
+Resizer::resizeInstance(Instance *inst,
+			LibertyCell *cell)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  debugPrint3(debug_, "resizer", 2, "%s %s -> %s\n",
+	      sdc_network_->pathName(inst),
+	      network_->libertyCell(inst)->name(),
+	      cell->name());
+  double inst_area = network->area(inst);
+  if (network->isLefCell(network_->cell(inst))) {
+    // Replace LEF with LEF so ports stay aligned in instance.
+    Cell *lef_cell = network->lefCell(cell);
+    if (lef_cell) {
+      editReplaceCell(inst, lef_cell);
+      resize_count_++;
+      design_area_ += network->area(inst) - inst_area;
+      return true;
+    }
+  }
+  else {
+    editReplaceCell(inst, network_->cell(cell));
+    resize_count_++;
+    design_area_ += network->area(inst) - inst_area;
+    return true;
+  }
+  return false;
 }
 
 static Pin *
@@ -510,6 +1412,573 @@ singleOutputPin(const Instance *inst,
   return output;
 }
 
+////////////////////////////////////////////////////////////////
+
+// Timing driven resizing with Lagrangian relaxation.
+//
+// The timing constraints are relaxed into the objective with a
+// multiplier (lambda) on each gate output. The relaxed problem
+// separates into one local subproblem per gate: choose the equivalent
+// cell that minimizes
+//
+//   lambda * delay(gate)
+//   + sum(fanin lambda * change in fanin driver delay)
+//   + area_weight * area(cell)
+//
+// The change in fanin driver delay comes from the input pin
+// capacitance of the candidate cell. The subproblems only read
+// timing, so they are solved in parallel and the results are committed
+// serially in level order.
+//
+// The multipliers are updated with a projected subgradient step. The
+// subgradient of the dual for a gate is its timing violation (negative
+// slack), normalized by the worst slack, so
+//
+//   lambda = clip(lambda - step * slack / slack_ref, 0, lambda_max)
+//
+// with a step size that diminishes as 1 / iteration. Gates with
+// positive slack are driven toward zero (area only) and unconstrained
+// gates drop out of the timing cost. The projection onto the
+// flow conservation conditions of the full formulation is not done
+// because the multipliers are per gate instead of per timing arc.
+
+class LrFanin
+{
+public:
+  LrFanin(const Pin *input_pin,
+	  const Pin *drvr_pin,
+	  int drvr_index);
+
+  // Gate input pin the fanin driver drives.
+  const Pin *input_pin_;
+  LibertyPort *input_;
+  const Pin *drvr_pin_;
+  // Index of the fanin driver gate.
+  int drvr_index_;
+  LibertyPort *drvr_port_;
+  float drvr_load_cap_;
+};
+
+LrFanin::LrFanin(const Pin *input_pin,
+		 const Pin *drvr_pin,
+		 int drvr_index) :
+  input_pin_(input_pin),
+  input_(nullptr),
+  drvr_pin_(drvr_pin),
+  drvr_index_(drvr_index),
+  drvr_port_(nullptr),
+  drvr_load_cap_(0.0)
+{
+}
+
+typedef Vector<LrFanin> LrFaninSeq;
+
+class LrGate
+{
+public:
+  LrGate(Instance *inst,
+	 Vertex *drvr);
+
+  Instance *inst_;
+  Vertex *drvr_;
+  LibertyCell *cell_;
+  LibertyPort *output_;
+  bool is_lef_;
+  float load_cap_;
+  Slew in_slews_[TransRiseFall::index_count];
+  float lambda_;
+  LrFaninSeq fanins_;
+  // Result of the local subproblem.
+  LibertyCell *best_cell_;
+};
+
+LrGate::LrGate(Instance *inst,
+	       Vertex *drvr) :
+  inst_(inst),
+  drvr_(drvr),
+  cell_(nullptr),
+  output_(nullptr),
+  is_lef_(false),
+  load_cap_(0.0),
+  lambda_(1.0),
+  best_cell_(nullptr)
+{
+  for (auto tr_index : TransRiseFall::rangeIndex())
+    in_slews_[tr_index] = 0.0;
+}
+
+// Initial subgradient step size and upper bound of the multipliers.
+static const float lr_step_init = 1.0;
+static const float lr_lambda_max = 1e+3;
+// Smaller designs are not worth the thread startup.
+static const size_t lr_thread_gate_min = 1000;
+
+void
+Resizer::resizeTimingDriven(int max_iterations)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  resize_count_ = 0;
+  // The subproblems read the cell data in parallel.
+  network->ensureCellData();
+  ensureLevelDrvrVerticies();
+  // Make sure the area limit is checked against the current area.
+  designArea();
+  LrGateSeq gates;
+  makeLrGates(gates);
+  makeLrTableBatches(gates);
+  float area_weight = lrAreaWeight(gates);
+  int iteration = 0;
+  while (iteration < max_iterations) {
+    updateLrGates(gates);
+    updateLrMultipliers(gates, iteration);
+    solveLrGates(gates, area_weight);
+    int changed = 0;
+    // The gates refer to graph vertices so the graph is updated
+    // incrementally.
+    beginEditBatch();
+    for (auto gate : gates) {
+      LibertyCell *best_cell = gate->best_cell_;
+      if (best_cell && best_cell != gate->cell_) {
+	double area_delta = network->area(best_cell)
+	  - network->area(gate->cell_);
+	// Keep growing gates under the utilization limit.
+	if (area_delta > 0.0
+	    && max_area_
+	    && design_area_ + area_delta > max_area_)
+	  continue;
+	if (resizeInstance(gate->inst_, best_cell))
+	  changed++;
+      }
+    }
+    commitEditBatch();
+    iteration++;
+    debugPrint2(debug_, "resizer", 1, "lr iteration %d resized %d\n",
+		iteration,
+		changed);
+    if (changed == 0)
+      break;
+    writeSessionCheckpoint();
+    if (overMaxArea())
+      // Make area more expensive so the next iteration gives some back.
+      area_weight *= 2.0;
+  }
+  gates.deleteContentsClear();
+  report_->print("Resized %d instances in %d iterations.\n",
+		 resize_count_,
+		 iteration);
+}
+
+// The gates and their fanin connections do not change while resizing,
+// so they are found once.
+void
+Resizer::makeLrGates(// Return value.
+		     LrGateSeq &gates)
+{
+  UnorderedMap<Vertex*, int> drvr_gate_index;
+  for (auto vertex : level_drvr_verticies_) {
+    Pin *drvr_pin = vertex->pin();
+    if (!network_->isTopLevelPort(drvr_pin)) {
+      Instance *inst = network_->instance(drvr_pin);
+      // Only resize single output gates for now.
+      if (network_->libertyCell(inst)
+	  && singleOutputPin(inst, network_) == drvr_pin
+	  // Hands off the clock nets.
+	  && !isClock(vertex)) {
+	drvr_gate_index[vertex] = gates.size();
+	gates.push_back(new LrGate(inst, vertex));
+      }
+    }
+  }
+  for (auto gate : gates) {
+    InstancePinIterator *pin_iter = network_->pinIterator(gate->inst_);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      Net *net = network_->net(pin);
+      if (network_->libertyPort(pin)
+	  && network_->direction(pin)->isAnyInput()
+	  && net) {
+	PinSet *drvrs = network_->drivers(net);
+	if (drvrs) {
+	  PinSet::Iterator drvr_iter(drvrs);
+	  while (drvr_iter.hasNext()) {
+	    Pin *drvr_pin = drvr_iter.next();
+	    Vertex *drvr_vertex = graph_->pinDrvrVertex(drvr_pin);
+	    int drvr_index;
+	    bool exists;
+	    drvr_gate_index.findKey(drvr_vertex, drvr_index, exists);
+	    if (exists)
+	      gate->fanins_.push_back(LrFanin(pin, drvr_pin, drvr_index));
+	  }
+	}
+      }
+    }
+    delete pin_iter;
+  }
+}
+
+// Make the table batches for the candidate cells before the
+// subproblems read gate_table_batches_ in parallel.
+void
+Resizer::makeLrTableBatches(LrGateSeq &gates)
+{
+  LibertyCellSet cells;
+  for (auto gate : gates) {
+    LibertyCell *cell = network_->libertyCell(gate->inst_);
+    auto equiv_cells = equivCells(cell);
+    if (equiv_cells) {
+      for (auto equiv : *equiv_cells)
+	cells.insert(equiv);
+    }
+    cells.insert(cell);
+  }
+  for (auto cell : cells)
+    makeGateTableBatches(cell);
+}
+
+// Scale area so one average gate area costs about one target slew of
+// delay.
+float
+Resizer::lrAreaWeight(LrGateSeq &gates)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  double area_sum = 0.0;
+  for (auto gate : gates)
+    area_sum += network->area(gate->inst_);
+  if (area_sum > 0.0) {
+    float delay_ref = (tgt_slews_[TransRiseFall::riseIndex()]
+		       + tgt_slews_[TransRiseFall::fallIndex()]) / 2.0;
+    return delay_ref * gates.size() / area_sum;
+  }
+  else
+    return 0.0;
+}
+
+void
+Resizer::makeGateTableBatches(LibertyCell *cell)
+{
+  LibertyCellTimingArcSetIterator set_iter(cell);
+  while (set_iter.hasNext()) {
+    TimingArcSet *arc_set = set_iter.next();
+    TimingArcSetArcIterator arc_iter(arc_set);
+    while (arc_iter.hasNext()) {
+      TimingArc *arc = arc_iter.next();
+      gateTableBatch(cell, arc);
+    }
+  }
+}
+
+// Update the cells, load caps and slews after resizing.
+// Resizing only invalidates the delays in the fanout cones of the
+// resized gates, so the delays are updated incrementally in level order
+// up to each gate instead of with a full findDelays.
+void
+Resizer::updateLrGates(LrGateSeq &gates)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  for (auto gate : gates) {
+    findDelays(gate->drvr_);
+    Instance *inst = gate->inst_;
+    const Pin *drvr_pin = gate->drvr_->pin();
+    gate->cell_ = network_->libertyCell(inst);
+    gate->output_ = network_->libertyPort(drvr_pin);
+    gate->is_lef_ = network->isLefCell(network_->cell(inst));
+    gate->load_cap_ = graph_delay_calc_->loadCap(drvr_pin, dcalc_ap_);
+    gate->best_cell_ = nullptr;
+    findInputSlews(inst, gate->in_slews_);
+    for (auto &fanin : gate->fanins_) {
+      fanin.input_ = network_->libertyPort(fanin.input_pin_);
+      fanin.drvr_port_ = network_->libertyPort(fanin.drvr_pin_);
+      fanin.drvr_load_cap_ = graph_delay_calc_->loadCap(fanin.drvr_pin_,
+							dcalc_ap_);
+    }
+  }
+}
+
+// Projected subgradient step on the multipliers.
+// The slacks are found incrementally from the delays updated by
+// updateLrGates.
+void
+Resizer::updateLrMultipliers(LrGateSeq &gates,
+			     int iteration)
+{
+  Slack worst_slack;
+  Vertex *worst_vertex;
+  worstSlack(min_max_, worst_slack, worst_vertex);
+  float slack_ref = max(abs(delayAsFloat(worst_slack)),
+			tgt_slews_[TransRiseFall::riseIndex()]);
+  float step = lr_step_init / (iteration + 1);
+  for (auto gate : gates) {
+    Slack slack = vertexSlack(gate->drvr_, min_max_);
+    if (fuzzyInf(slack))
+      // Unconstrained gates only see the area cost.
+      gate->lambda_ = 0.0;
+    else {
+      float subgradient = -delayAsFloat(slack) / slack_ref;
+      gate->lambda_ = min(max(gate->lambda_ + step * subgradient, 0.0F),
+			  lr_lambda_max);
+    }
+  }
+}
+
+void
+Resizer::solveLrGates(LrGateSeq &gates,
+		      float area_weight)
+{
+  size_t gate_count = gates.size();
+  int thread_count = threadCount();
+  if (thread_count <= 1
+      || gate_count < lr_thread_gate_min) {
+    for (auto gate : gates)
+      solveLrGate(gate, gates, area_weight);
+  }
+  else {
+    // Contiguous gate ranges so each thread touches its own results.
+    size_t chunk_size = (gate_count + thread_count - 1) / thread_count;
+    Vector<std::thread> threads;
+    for (size_t begin = 0; begin < gate_count; begin += chunk_size) {
+      size_t end = min(begin + chunk_size, gate_count);
+      threads.push_back(std::thread([=, &gates] () {
+	    for (size_t i = begin; i < end; i++)
+	      solveLrGate(gates[i], gates, area_weight);
+	  }));
+    }
+    for (auto &thread : threads)
+      thread.join();
+  }
+}
+
+// Solve the local subproblem for one gate.
+// Only reads the network, cell data, timing and gate_table_batches_ so
+// gates can be solved concurrently.
+void
+Resizer::solveLrGate(LrGate *gate,
+		     const LrGateSeq &gates,
+		     float area_weight)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  LibertyCell *cell = gate->cell_;
+  auto equiv_cells = equivCells(cell);
+  if (equiv_cells == nullptr)
+    return;
+  LibertyCellSeq candidates;
+  // The current cell is candidate 0 so ties keep it.
+  candidates.push_back(cell);
+  for (auto target_cell : *equiv_cells) {
+    if (target_cell != cell
+	&& !dontUse(target_cell)
+	// Replace LEF with LEF so ports stay aligned in instance.
+	&& (!gate->is_lef_ || network->lefCell(target_cell)))
+      candidates.push_back(target_cell);
+  }
+  size_t candidate_count = candidates.size();
+  if (candidate_count == 1)
+    return;
+
+  FloatSeq costs(candidate_count);
+  for (size_t i = 0; i < candidate_count; i++) {
+    LibertyCell *target_cell = candidates[i];
+    LibertyPort *output = target_cell->findLibertyPort(gate->output_->name());
+    float delay, slew;
+    gateDelay(output, gate->in_slews_, gate->load_cap_, delay, slew);
+    costs[i] = gate->lambda_ * delay
+      + area_weight * network->area(target_cell);
+  }
+  // Fanin driver delays for all candidates in one batch per fanin.
+  FloatSeq load_caps(candidate_count);
+  FloatSeq drvr_delays;
+  for (auto &fanin : gate->fanins_) {
+    if (fanin.input_ && fanin.drvr_port_) {
+      float input_cap = portCapacitance(fanin.input_);
+      for (size_t i = 0; i < candidate_count; i++) {
+	LibertyPort *input = candidates[i]->findLibertyPort(fanin.input_->name());
+	float cap_delta = input ? portCapacitance(input) - input_cap : 0.0;
+	load_caps[i] = fanin.drvr_load_cap_ + cap_delta;
+      }
+      gateDelays(fanin.drvr_port_, load_caps, drvr_delays);
+      float drvr_lambda = gates[fanin.drvr_index_]->lambda_;
+      // Candidate 0 is the current cell so delays are relative to it.
+      for (size_t i = 1; i < candidate_count; i++)
+	costs[i] += drvr_lambda * (drvr_delays[i] - drvr_delays[0]);
+    }
+  }
+  size_t best_index = 0;
+  for (size_t i = 1; i < candidate_count; i++) {
+    if (costs[i] < costs[best_index])
+      best_index = i;
+  }
+  gate->best_cell_ = candidates[best_index];
+}
+
+////////////////////////////////////////////////////////////////
+
+// What-if estimates use the current parasitics and input slews with
+// local delay calculation, so the network and timing graph are not
+// touched. Wire delays and the effect of the driver slew on the load
+// delays are ignored.
+
+bool
+Resizer::estimateReplaceCell(Instance *inst,
+			     LibertyCell *cell,
+			     // Return values.
+			     float &delay,
+			     float &slew,
+			     float &load_cap,
+			     float &required_delta)
+{
+  LibertyCell *inst_cell = network_->libertyCell(inst);
+  Pin *output = singleOutputPin(inst, network_);
+  if (inst_cell && output
+      && isEquivCell(inst_cell, cell)) {
+    LibertyPort *inst_output = network_->libertyPort(output);
+    LibertyPort *cell_output = cell->findLibertyPort(inst_output->name());
+    if (cell_output) {
+      ensureCorner();
+      // Only the delays up to the instance output are needed.
+      findDelays(graph_->pinDrvrVertex(output));
+      Slew in_slews[TransRiseFall::index_count];
+      findInputSlews(inst, in_slews);
+      load_cap = graph_delay_calc_->loadCap(output, dcalc_ap_);
+      float inst_delay, inst_slew;
+      gateDelay(inst_output, in_slews, load_cap, inst_delay, inst_slew);
+      gateDelay(cell_output, in_slews, load_cap, delay, slew);
+      required_delta = inst_delay - delay
+	- faninDelayIncrease(inst, cell);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+Resizer::isEquivCell(LibertyCell *inst_cell,
+		     LibertyCell *cell)
+{
+  if (cell == inst_cell)
+    return true;
+  auto equiv_cells = equivCells(inst_cell);
+  if (equiv_cells) {
+    for (auto equiv : *equiv_cells) {
+      if (equiv == cell)
+	return true;
+    }
+  }
+  return false;
+}
+
+// Worst increase in the delay of the gates driving the inputs of inst
+// when the input pin capacitances change to those of cell.
+float
+Resizer::faninDelayIncrease(const Instance *inst,
+			    LibertyCell *cell)
+{
+  float delay_increase = 0.0;
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    LibertyPort *input = network_->libertyPort(pin);
+    Net *net = network_->net(pin);
+    if (input
+	&& network_->direction(pin)->isAnyInput()
+	&& net) {
+      LibertyPort *cell_input = cell->findLibertyPort(input->name());
+      float cap_delta = cell_input
+	? portCapacitance(cell_input) - portCapacitance(input)
+	: 0.0;
+      PinSet *drvrs = network_->drivers(net);
+      if (drvrs && cap_delta != 0.0) {
+	PinSet::Iterator drvr_iter(drvrs);
+	while (drvr_iter.hasNext()) {
+	  Pin *drvr_pin = drvr_iter.next();
+	  LibertyPort *drvr_port = network_->libertyPort(drvr_pin);
+	  if (drvr_port
+	      && !network_->isTopLevelPort(drvr_pin)) {
+	    Slew drvr_in_slews[TransRiseFall::index_count];
+	    findInputSlews(network_->instance(drvr_pin), drvr_in_slews);
+	    float drvr_load_cap = graph_delay_calc_->loadCap(drvr_pin,
+							     dcalc_ap_);
+	    float drvr_delay, drvr_delay1, drvr_slew;
+	    gateDelay(drvr_port, drvr_in_slews, drvr_load_cap,
+		      drvr_delay, drvr_slew);
+	    gateDelay(drvr_port, drvr_in_slews, drvr_load_cap + cap_delta,
+		      drvr_delay1, drvr_slew);
+	    delay_increase = max(delay_increase, drvr_delay1 - drvr_delay);
+	  }
+	}
+      }
+    }
+  }
+  delete pin_iter;
+  return delay_increase;
+}
+
+bool
+Resizer::estimateInsertBuffer(const Pin *drvr_pin,
+			      LibertyCell *buffer_cell,
+			      // Return values.
+			      float &delay,
+			      float &slew,
+			      float &load_cap,
+			      float &required_delta)
+{
+  LibertyPort *drvr_port = network_->libertyPort(drvr_pin);
+  if (drvr_port
+      && network_->isDriver(drvr_pin)
+      && !network_->isTopLevelPort(drvr_pin)) {
+    ensureCorner();
+    // Only the delays up to the driver are needed.
+    findDelays(graph_->pinDrvrVertex(drvr_pin));
+    Instance *inst = network_->instance(drvr_pin);
+    Slew in_slews[TransRiseFall::index_count];
+    findInputSlews(inst, in_slews);
+    float net_load_cap = graph_delay_calc_->loadCap(drvr_pin, dcalc_ap_);
+    float drvr_delay, drvr_slew;
+    gateDelay(drvr_port, in_slews, net_load_cap, drvr_delay, drvr_slew);
+
+    // The buffer input is at the driver and the buffer drives the net.
+    LibertyPort *input, *output;
+    buffer_cell->bufferPorts(input, output);
+    load_cap = portCapacitance(input);
+    float buffer_drvr_delay, buffer_drvr_slew;
+    gateDelay(drvr_port, in_slews, load_cap,
+	      buffer_drvr_delay, buffer_drvr_slew);
+    Slew buffer_in_slews[TransRiseFall::index_count];
+    for (auto tr_index : TransRiseFall::rangeIndex())
+      buffer_in_slews[tr_index] = buffer_drvr_slew;
+    float buffer_delay;
+    gateDelay(output, buffer_in_slews, net_load_cap, buffer_delay, slew);
+    delay = buffer_drvr_delay + buffer_delay;
+    required_delta = drvr_delay - delay;
+    return true;
+  }
+  return false;
+}
+
+// Worst slews at the instance inputs.
+void
+Resizer::findInputSlews(const Instance *inst,
+			// Return values.
+			Slew in_slews[])
+{
+  int ap_index = dcalc_ap_->index();
+  for (auto tr_index : TransRiseFall::rangeIndex())
+    in_slews[tr_index] = 0.0;
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (network_->direction(pin)->isAnyInput()) {
+      Vertex *vertex = graph_->pinLoadVertex(pin);
+      if (vertex) {
+	for (auto tr : TransRiseFall::range()) {
+	  int tr_index = tr->index();
+	  float slew = delayAsFloat(graph_->slew(vertex, tr, ap_index));
+	  in_slews[tr_index] = max(delayAsFloat(in_slews[tr_index]), slew);
+	}
+      }
+    }
+  }
+  delete pin_iter;
+}
+
 void
 Resizer::setMaxUtilization(double max_utilization)
 {
@@ -522,6 +1991,89 @@ Resizer::overMaxArea()
   return max_area_ && design_area_ > max_area_;
 }
 
+void
+Resizer::setTileCount(int tile_count)
+{
+  tile_count_ = tile_count;
+}
+
+bool
+Resizer::useTiles() const
+{
+  return tile_count_ > 1 && haveCoreArea();
+}
+
+// Return the tile containing all of the pins of net, or -1 if the pins
+// are in more than one tile or are not placed.
+int
+Resizer::netTile(const Net *net)
+{
+  if (net == nullptr)
+    return -1;
+  LefDefNetwork *network = lefDefNetwork();
+  int tile = -1;
+  NetConnectedPinIterator *pin_iter = network->connectedPinIterator(net);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    if (!network->isPlaced(pin)) {
+      tile = -1;
+      break;
+    }
+    int pin_tile = tileIndex(network->location(pin));
+    if (tile == -1)
+      tile = pin_tile;
+    else if (pin_tile != tile) {
+      tile = -1;
+      break;
+    }
+  }
+  delete pin_iter;
+  return tile;
+}
+
+// Tiles are a fixed grid over the core area. Locations outside the core
+// are in the nearest edge tile.
+int
+Resizer::tileIndex(DefPt location) const
+{
+  const LefDefNetwork *network = lefDefNetwork();
+  double x = network->dbuToMeters(location.x());
+  double y = network->dbuToMeters(location.y());
+  int tile_x = (x - core_lx_) / (core_ux_ - core_lx_) * tile_count_;
+  int tile_y = (y - core_ly_) / (core_uy_ - core_ly_) * tile_count_;
+  tile_x = max(0, min(tile_x, tile_count_ - 1));
+  tile_y = max(0, min(tile_y, tile_count_ - 1));
+  return tile_y * tile_count_ + tile_x;
+}
+
+// Call func for each tile, on the worker threads if parallel.
+// Tiles are handed to the threads as they finish the previous one
+// because the number of nets per tile varies with the placement density.
+void
+Resizer::forEachTile(bool parallel,
+		     const std::function<void (int tile)> &func)
+{
+  int tile_count = tile_count_ * tile_count_;
+  int thread_count = min(threadCount(), tile_count);
+  if (!parallel
+      || thread_count <= 1) {
+    for (int tile = 0; tile < tile_count; tile++)
+      func(tile);
+  }
+  else {
+    std::atomic<int> next_tile(0);
+    Vector<std::thread> threads;
+    for (int i = 0; i < thread_count; i++) {
+      threads.push_back(std::thread([&] () {
+	    for (int tile = next_tile++; tile < tile_count; tile = next_tile++)
+	      func(tile);
+	  }));
+    }
+    for (auto &thread : threads)
+      thread.join();
+  }
+}
+
 void
 Resizer::setDontUse(LibertyCellSeq *dont_use)
 {
@@ -545,35 +2097,88 @@ Resizer::dontUse(LibertyCell *cell)
 void
 Resizer::findTargetLoads(LibertyLibrarySeq *resize_libs)
 {
+  // The target loads only depend on the libraries and the corner,
+  // so they are kept between resizes and in sessions.
+  if (target_load_map_
+      && target_load_libs_ == *resize_libs)
+    return;
   // Find target slew across all buffers in the libraries.
   findBufferTargetSlews(resize_libs);
   if (target_load_map_ == nullptr)
     target_load_map_ = new CellTargetLoadMap;
-  for (auto lib : *resize_libs)
-    findTargetLoads(lib, tgt_slews_);
+  target_load_libs_ = *resize_libs;
+  LibertyCellSeq cells;
+  for (auto lib : *resize_libs) {
+    LibertyCellIterator cell_iter(lib);
+    while (cell_iter.hasNext())
+      cells.push_back(cell_iter.next());
+  }
+  findTargetLoads(cells, tgt_slews_);
 }
 
 float
 Resizer::targetLoadCap(LibertyCell *cell)
 {
   float load_cap = 0.0;
-  bool exists;
-  target_load_map_->findKey(cell, load_cap, exists);
+  if (target_load_map_) {
+    bool exists;
+    target_load_map_->findKey(cell, load_cap, exists);
+  }
   return load_cap;
 }
 
+// Smaller libraries are not worth the thread startup.
+static const size_t target_load_thread_cell_min = 64;
+
+// Cells are characterized independently, so each thread finds the
+// target loads for a range of cells. The results are merged after the
+// threads finish.
 void
-Resizer::findTargetLoads(LibertyLibrary *library,
+Resizer::findTargetLoads(const LibertyCellSeq &cells,
 			 Slew slews[])
 {
-  LibertyCellIterator cell_iter(library);
-  while (cell_iter.hasNext()) {
-    auto cell = cell_iter.next();
-    findTargetLoad(cell, slews);
+  size_t cell_count = cells.size();
+  FloatSeq target_loads(cell_count);
+  int thread_count = threadCount();
+  if (thread_count <= 1
+      || cell_count < target_load_thread_cell_min)
+    findTargetLoads(cells, 0, cell_count, slews, target_loads);
+  else {
+    size_t chunk_size = (cell_count + thread_count - 1) / thread_count;
+    Vector<std::thread> threads;
+    for (size_t begin = 0; begin < cell_count; begin += chunk_size) {
+      size_t end = min(begin + chunk_size, cell_count);
+      threads.push_back(std::thread([=, &cells, &target_loads] () {
+	    findTargetLoads(cells, begin, end, slews, target_loads);
+	  }));
+    }
+    for (auto &thread : threads)
+      thread.join();
+  }
+  for (size_t i = 0; i < cell_count; i++) {
+    LibertyCell *cell = cells[i];
+    float target_load = target_loads[i];
+    (*target_load_map_)[cell] = target_load;
+    debugPrint2(debug_, "resizer", 3, "%s target_load = %.2e\n",
+		cell->name(),
+		target_load);
   }
 }
 
+// Find target loads for cells[begin, end).
 void
+Resizer::findTargetLoads(const LibertyCellSeq &cells,
+			 size_t begin,
+			 size_t end,
+			 Slew slews[],
+			 // Return values.
+			 FloatSeq &target_loads)
+{
+  for (size_t i = begin; i < end; i++)
+    target_loads[i] = findTargetLoad(cells[i], slews);
+}
+
+float
 Resizer::findTargetLoad(LibertyCell *cell,
 			Slew slews[])
 {
@@ -599,15 +2204,14 @@ Resizer::findTargetLoad(LibertyCell *cell,
       }
     }
   }
-  float target_load = (arc_count > 0) ? target_load_sum / arc_count : 0.0;
-  (*target_load_map_)[cell] = target_load;
-  debugPrint2(debug_, "resizer", 3, "%s target_load = %.2e\n",
-	      cell->name(),
-	      target_load);
+  return (arc_count > 0) ? target_load_sum / arc_count : 0.0;
 }
 
 // Find the load capacitance that will cause the output slew
 // to be equal to out_slew.
+// Each probe depends on the previous one, so the search uses the
+// scalar model instead of a table batch. The model only reads the
+// library, so cells can be characterized concurrently.
 float
 Resizer::findTargetLoad(LibertyCell *cell,
 			TimingArc *arc,
@@ -692,17 +2296,14 @@ Resizer::findBufferTargetSlews(LibertyLibrary *library,
 	  TimingArcSetArcIterator arc_iter(arc_set);
 	  while (arc_iter.hasNext()) {
 	    TimingArc *arc = arc_iter.next();
-	    GateTimingModel *model = dynamic_cast<GateTimingModel*>(arc->model());
+	    GateTableBatch *batch = gateTableBatch(buffer, arc);
 	    TransRiseFall *in_tr = arc->fromTrans()->asRiseFall();
 	    TransRiseFall *out_tr = arc->toTrans()->asRiseFall();
 	    float in_cap = input->capacitance(in_tr, min_max_);
 	    float load_cap = in_cap * 10.0; // "factor debatable"
-	    ArcDelay arc_delay;
-	    Slew arc_slew;
-	    model->gateDelay(buffer, pvt_, 0.0, load_cap, 0.0, false,
-			     arc_delay, arc_slew);
-	    model->gateDelay(buffer, pvt_, arc_slew, load_cap, 0.0, false,
-			     arc_delay, arc_slew);
+	    float arc_delay, arc_slew;
+	    batch->gateDelay(0.0, load_cap, arc_delay, arc_slew);
+	    batch->gateDelay(arc_slew, load_cap, arc_delay, arc_slew);
 	    slews[out_tr->index()] += arc_slew;
 	    counts[out_tr->index()]++;
 	  }
@@ -747,19 +2348,20 @@ Resizer::initFlute(const char *resizer_path)
 ////////////////////////////////////////////////////////////////
 
 void
-Resizer::ensureClkNets()
+Resizer::ensureClkVertices()
 {
-  if (!clk_nets__valid_) {
-    findClkNets();
-    clk_nets__valid_ = true;
+  if (!clk_vertices_valid_) {
+    findClkVertices();
+    clk_vertices_valid_ = true;
   }
 }
 
-// Find clock nets.
+// Find the vertices on clock nets.
 // This is not as reliable as Search::isClock but is much cheaper.
 void
-Resizer::findClkNets()
+Resizer::findClkVertices()
 {
+  clk_vertices_.clear();
   ClkArrivalSearchPred srch_pred(this);
   BfsFwdIterator bfs(BfsIndex::other, &srch_pred, this);
   PinSet clk_pins;
@@ -773,17 +2375,94 @@ Resizer::findClkNets()
   }  
   while (bfs.hasNext()) {
     Vertex *vertex = bfs.next();
-    const Pin *pin = vertex->pin();
-    Net *net = network_->net(pin);
-    clk_nets_.insert(net);
+    setClock(vertex);
     bfs.enqueueAdjacentVertices(vertex);
   }
 }
 
+// Nets do not have ids, so clock membership is a bit per graph vertex.
+// A net is a clock net if one of its drivers is on a clock net.
+bool
+Resizer::isClock(const Net *net) const
+{
+  if (net) {
+    PinSet *drvrs = network_->drivers(net);
+    if (drvrs) {
+      PinSet::Iterator drvr_iter(drvrs);
+      while (drvr_iter.hasNext()) {
+	Pin *drvr = drvr_iter.next();
+	if (isClock(graph_->pinDrvrVertex(drvr)))
+	  return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool
-Resizer::isClock(Net *net)
+Resizer::isClock(const Vertex *vertex) const
+{
+  if (vertex) {
+    VertexId id = graph_->id(vertex);
+    // Vertices made after the clock vertices were found are only on
+    // clock nets if setClock marks them.
+    return id < clk_vertices_.size()
+      && clk_vertices_[id];
+  }
+  return false;
+}
+
+void
+Resizer::setClock(const Vertex *vertex)
+{
+  VertexId id = graph_->id(vertex);
+  if (id >= clk_vertices_.size())
+    clk_vertices_.resize(id + 1, false);
+  clk_vertices_[id] = true;
+}
+
+// Clear the clock bits of the instance pin vertices before they are
+// deleted so the vertex ids can be reused.
+void
+Resizer::clearClock(const Instance *inst)
 {
-  return clk_nets_.hasKey(net);
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    Vertex *vertex, *bidirect_drvr_vertex;
+    graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+    for (auto clk_vertex : {vertex, bidirect_drvr_vertex}) {
+      if (clk_vertex) {
+	VertexId id = graph_->id(clk_vertex);
+	if (id < clk_vertices_.size())
+	  clk_vertices_[id] = false;
+      }
+    }
+  }
+  delete pin_iter;
+}
+
+// A buffer inserted on a clock net is on clock nets.
+void
+Resizer::updateBufferClock(Instance *buffer,
+			   const Net *net)
+{
+  // Network only edit batches find the clock vertices when they are
+  // committed.
+  if (!edit_batch_network_only_
+      && isClock(net)) {
+    InstancePinIterator *pin_iter = network_->pinIterator(buffer);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      Vertex *vertex, *bidirect_drvr_vertex;
+      graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+      if (vertex)
+	setClock(vertex);
+      if (bidirect_drvr_vertex)
+	setClock(bidirect_drvr_vertex);
+    }
+    delete pin_iter;
+  }
 }
 
 ////////////////////////////////////////////////////////////////
@@ -803,14 +2482,21 @@ Resizer::makeNetParasitics()
 
 void
 Resizer::makeNetParasitics(const Net *net)
+{
+  ParasiticSegmentSeq segments;
+  if (findNetWireSegments(net, segments))
+    makeNetParasitics(net, segments);
+}
+
+bool
+Resizer::findNetWireSegments(const Net *net,
+			     // Return value.
+			     ParasiticSegmentSeq &segments)
 {
   LefDefNetwork *network = lefDefNetwork();
   SteinerTree *tree = makeSteinerTree(net, false, network);
-  if (tree && tree->isPlaced(network)) {
-    debugPrint1(debug_, "resizer_parasitics", 1, "net %s\n",
-		sdc_network_->pathName(net));
-    Parasitic *parasitic = parasitics_->makeParasiticNetwork(net, false,
-							     parasitics_ap_);
+  bool placed = tree && tree->isPlaced(network);
+  if (placed) {
     int branch_count = tree->branchCount();
     for (int i = 0; i < branch_count; i++) {
       DefPt pt1, pt2;
@@ -821,44 +2507,86 @@ Resizer::makeNetParasitics(const Net *net)
 		   pt1, pin1, steiner_pt1,
 		   pt2, pin2, steiner_pt2,
 		   wire_length_dbu);
-      ParasiticNode *n1 = findParasiticNode(tree, parasitic, net, pin1, steiner_pt1);
-      ParasiticNode *n2 = findParasiticNode(tree, parasitic, net, pin2, steiner_pt2);
-      if (n1 != n2) {
+      // If the steiner pt is on top of a pin, use the pin instead.
+      if (pin1 == nullptr)
+	pin1 = tree->steinerPtAlias(steiner_pt1);
+      if (pin2 == nullptr)
+	pin2 = tree->steinerPtAlias(steiner_pt2);
+      if (pin1 != pin2
+	  || (pin1 == nullptr && steiner_pt1 != steiner_pt2)) {
 	if (wire_length_dbu == 0)
 	  // Use a small resistor to keep the connectivity intact.
-	  parasitics_->makeResistor(nullptr, n1, n2, 1.0e-3, parasitics_ap_);
+	  segments.push_back(ParasiticSegment{pin1, steiner_pt1,
+					      pin2, steiner_pt2,
+					      1.0e-3, 0.0});
 	else {
 	  float wire_length = network->dbuToMeters(wire_length_dbu);
-	  float wire_cap = wire_length * wire_cap_;
-	  float wire_res = wire_length * wire_res_;
-	  // Make pi model for the wire.
-	  debugPrint5(debug_, "resizer_parasitics", 2,
-		      " pi %s c2=%s rpi=%s c1=%s %s\n",
-		      parasitics_->name(n1),
-		      units_->capacitanceUnit()->asString(wire_cap / 2.0),
-		      units_->resistanceUnit()->asString(wire_res),
-		      units_->capacitanceUnit()->asString(wire_cap / 2.0),
-		      parasitics_->name(n2));
-	  parasitics_->incrCap(n1, wire_cap / 2.0, parasitics_ap_);
-	  parasitics_->makeResistor(nullptr, n1, n2, wire_res, parasitics_ap_);
-	  parasitics_->incrCap(n2, wire_cap / 2.0, parasitics_ap_);
+	  segments.push_back(ParasiticSegment{pin1, steiner_pt1,
+					      pin2, steiner_pt2,
+					      wire_length * wire_res_,
+					      wire_length * wire_cap_});
 	}
       }
     }
-    delete tree;
+  }
+  delete tree;
+  return placed;
+}
+
+void
+Resizer::makeNetParasitics(const Net *net,
+			   const ParasiticSegmentSeq &segments)
+{
+  debugPrint1(debug_, "resizer_parasitics", 1, "net %s\n",
+	      sdc_network_->pathName(net));
+  Parasitic *parasitic = parasitics_->makeParasiticNetwork(net, false,
+							   parasitics_ap_);
+  for (const ParasiticSegment &segment : segments) {
+    ParasiticNode *n1 = findParasiticNode(parasitic, net, segment.pin1_,
+					  segment.steiner_pt1_);
+    ParasiticNode *n2 = findParasiticNode(parasitic, net, segment.pin2_,
+					  segment.steiner_pt2_);
+    // Make pi model for the wire.
+    debugPrint5(debug_, "resizer_parasitics", 2,
+		" pi %s c2=%s rpi=%s c1=%s %s\n",
+		parasitics_->name(n1),
+		units_->capacitanceUnit()->asString(segment.cap_ / 2.0),
+		units_->resistanceUnit()->asString(segment.res_),
+		units_->capacitanceUnit()->asString(segment.cap_ / 2.0),
+		parasitics_->name(n2));
+    if (segment.cap_ > 0.0)
+      parasitics_->incrCap(n1, segment.cap_ / 2.0, parasitics_ap_);
+    parasitics_->makeResistor(nullptr, n1, n2, segment.res_, parasitics_ap_);
+    if (segment.cap_ > 0.0)
+      parasitics_->incrCap(n2, segment.cap_ / 2.0, parasitics_ap_);
+  }
+  parasiticsInvalidDelays(net);
+}
+
+// The net driver delays and load slews depend on the parasitics so
+// the next findDelays recomputes them.
+void
+Resizer::parasiticsInvalidDelays(const Net *net)
+{
+  if (graph_
+      && !edit_batch_network_only_) {
+    PinSet *drvrs = network_->drivers(net);
+    if (drvrs) {
+      PinSet::Iterator drvr_iter(drvrs);
+      while (drvr_iter.hasNext()) {
+	Pin *drvr = drvr_iter.next();
+	graph_delay_calc_->delayInvalid(drvr);
+      }
+    }
   }
 }
 
 ParasiticNode *
-Resizer::findParasiticNode(SteinerTree *tree,
-			   Parasitic *parasitic,
+Resizer::findParasiticNode(Parasitic *parasitic,
 			   const Net *net,
 			   const Pin *pin,
 			   int steiner_pt)
 {
-  if (pin == nullptr)
-    // If the steiner pt is on top of a pin, use the pin instead.
-    pin = tree->steinerPtAlias(steiner_pt);
   if (pin)
     return parasitics_->ensureParasiticNode(parasitic, pin);
   else 
@@ -896,17 +2624,22 @@ public:
   Type type() const { return type_; }
   float cap() const { return cap_; }
   Required required() const { return required_; }
-  Required bufferRequired(LibertyCell *buffer_cell,
-			  Resizer *resizer) const;
+  // Required time at the input of a buffer driving this option.
+  // Resizer::findBufferRequireds() sets it for a batch of options.
+  Required bufferRequired() const { return buffer_required_; }
+  void setBufferRequired(Required required);
   DefPt location() const { return location_; }
   Pin *loadPin() const { return load_pin_; }
   RebufferOption *ref() const { return ref_; }
   RebufferOption *ref2() const { return ref2_; }
+  // Number of buffers rebufferTopDown inserts for the option.
+  int bufferCount() const;
 
 private:
   Type type_;
   float cap_;
   Required required_;
+  Required buffer_required_;
   Pin *load_pin_;
   DefPt location_;
   RebufferOption *ref_;
@@ -923,6 +2656,7 @@ RebufferOption::RebufferOption(Type type,
   type_(type),
   cap_(cap),
   required_(required),
+  buffer_required_(-INF),
   load_pin_(load_pin),
   location_(location),
   ref_(ref),
@@ -934,15 +2668,90 @@ RebufferOption::~RebufferOption()
 {
 }
 
-Required
-RebufferOption::bufferRequired(LibertyCell *buffer_cell,
-			       Resizer *resizer) const
+void
+RebufferOption::setBufferRequired(Required required)
+{
+  buffer_required_ = required;
+}
+
+int
+RebufferOption::bufferCount() const
 {
-  return required_ - resizer->bufferDelay(buffer_cell, cap_);
+  switch (type_) {
+  case Type::buffer:
+    return ref_->bufferCount() + 1;
+  case Type::wire:
+    return ref_->bufferCount();
+  case Type::junction:
+    return ref_->bufferCount() + ref2_->bufferCount();
+  case Type::sink:
+    return 0;
+  }
+  return 0;
 }
 
+typedef UnorderedMap<const Pin*, Required> PinRequiredMap;
+
+// Rebuffering state for one driver.
+// Options are owned by the net and deleted with it.
+class RebufferNet
+{
+public:
+  RebufferNet(const Pin *drvr_pin,
+	      Net *net,
+	      LibertyPort *drvr_port,
+	      SteinerTree *tree);
+  ~RebufferNet();
+  const Pin *drvrPin() const { return drvr_pin_; }
+  Net *net() const { return net_; }
+  LibertyPort *drvrPort() const { return drvr_port_; }
+  SteinerTree *tree() const { return tree_; }
+  RebufferOption *makeOption(RebufferOption::Type type,
+			     float cap,
+			     Required required,
+			     Pin *load_pin,
+			     DefPt location,
+			     RebufferOption *ref,
+			     RebufferOption *ref2);
+  Required loadRequired(const Pin *load_pin) const;
+  void setLoadRequired(const Pin *load_pin,
+		       Required required);
+  RebufferOption *best() const { return best_; }
+  void setBest(RebufferOption *best) { best_ = best; }
+  // Reserve the buffer and net name indices for the buffers
+  // the best option inserts.
+  void reserveNames(NameAllocator &buffer_names,
+		    NameAllocator &net_names);
+  bool namesReserved() const { return name_count_ >= 0; }
+  bool hasReservedNames() const { return name_count_ > 0; }
+  // Return the next reserved indices.
+  void nextNames(// Return values.
+		 int &buffer_index,
+		 int &net_index);
+
+private:
+  const Pin *drvr_pin_;
+  Net *net_;
+  LibertyPort *drvr_port_;
+  SteinerTree *tree_;
+  PinRequiredMap load_requireds_;
+  RebufferOptionSeq options_;
+  RebufferOption *best_;
+  int buffer_name_index_;
+  int net_name_index_;
+  // Reserved names not used yet, -1 before reserveNames.
+  int name_count_;
+};
+
 ////////////////////////////////////////////////////////////////
 
+// Drivers at the same level are not in each other's fanout, so their
+// nets are rebuffered together. The options for the nets in a level are
+// built in parallel and the netlist edits are committed serially in
+// reverse level order before the next level's required times are found.
+// Buffers inserted by a level and the fanout drivers of rebuffered nets
+// have new slews, so they are checked again with incrementally updated
+// delays after the last level.
 void
 Resizer::rebuffer(bool repair_max_cap,
 		  bool repair_max_slew,
@@ -951,26 +2760,165 @@ Resizer::rebuffer(bool repair_max_cap,
   inserted_buffer_count_ = 0;
   rebuffer_net_count_ = 0;
   findDelays();
+  makeGateTableBatches(buffer_cell);
+  ensureLevelDrvrVerticies();
+  // Rebuffering adds to level_drvr_verticies_ so use a copy.
+  VertexSeq drvrs = level_drvr_verticies_;
+  RebufferNetSeq rnets;
+  // Drivers that were rebuffered and drivers to check again.
+  VertexSet rebuffered, recheck;
+  rebuffer_drvrs_.clear();
+  bool over_max_area = false;
   // Rebuffer in reverse level order.
-  for (int i = level_drvr_verticies_.size() - 1; i >= 0; i--) {
-    Vertex *vertex = level_drvr_verticies_[i];
-    // Hands off the clock tree.
-    if (!search_->isClock(vertex)) {
-      Pin *drvr_pin = vertex->pin();
-      if ((repair_max_cap
-	   && hasMaxCapViolation(drvr_pin))
-	  || (repair_max_slew
-	      && hasMaxSlewViolation(drvr_pin))) {
-	rebuffer(drvr_pin, buffer_cell);
-	if (overMaxArea()) {
-	  report_->warn("max utilization reached.\n");
-	  break;
+  int i = drvrs.size() - 1;
+  while (i >= 0 && !over_max_area) {
+    Level level = drvrs[i]->level();
+    // Only delays invalidated by the previous levels are recomputed.
+    findDelays(drvrs[i]);
+    for (; i >= 0 && drvrs[i]->level() == level; i--) {
+      Vertex *vertex = drvrs[i];
+      // Hands off the clock tree.
+      if (!isClock(vertex)) {
+	Pin *drvr_pin = vertex->pin();
+	if ((repair_max_cap
+	     && hasMaxCapViolation(drvr_pin))
+	    || (repair_max_slew
+		&& hasMaxSlewViolation(drvr_pin))) {
+	  RebufferNet *rnet = makeRebufferNet(drvr_pin, buffer_cell);
+	  if (rnet)
+	    rnets.push_back(rnet);
+	}
+      }
+    }
+    if (useTiles())
+      solveRebufferTiles(rnets, buffer_cell);
+    else
+      solveRebufferNets(rnets, buffer_cell);
+    // The names only depend on the order of the nets, not on how
+    // the nets were divided between the threads.
+    reserveRebufferNames(rnets);
+    // The driver vertices are used after the edits so the graph is
+    // updated incrementally. The parasitics of the rebuffered nets
+    // are estimated once for the level.
+    beginEditBatch();
+    for (auto rnet : rnets) {
+      commitRebufferNet(rnet, buffer_cell);
+      rebuffered.insert(graph_->pinDrvrVertex(rnet->drvrPin()));
+      findRebufferRecheck(rnet, recheck);
+      if (overMaxArea()) {
+	report_->warn("max utilization reached.\n");
+	over_max_area = true;
+	break;
+      }
+    }
+    commitEditBatch();
+    rnets.deleteContentsClear();
+    writeSessionCheckpoint();
+  }
+  if (!over_max_area)
+    rebufferRecheck(repair_max_cap, repair_max_slew, buffer_cell,
+		    rebuffered, recheck);
+}
+
+// Drivers whose slews changed because rnet was rebuffered:
+// the inserted buffers and the drivers of the net loads.
+void
+Resizer::findRebufferRecheck(RebufferNet *rnet,
+			     // Return value.
+			     VertexSet &recheck)
+{
+  Vertex *drvr_vertex = graph_->pinDrvrVertex(rnet->drvrPin());
+  if (drvr_vertex)
+    findFanoutDrvrs(drvr_vertex->pin(), recheck);
+  for (auto buffer_drvr : rebuffer_drvrs_) {
+    recheck.insert(buffer_drvr);
+    findFanoutDrvrs(buffer_drvr->pin(), recheck);
+  }
+  rebuffer_drvrs_.clear();
+}
+
+// Check the drivers in recheck again after updating the delays
+// and slews in their fanin cones. Slews propagate forward so the
+// drivers are checked in level order and rebuffering one can add
+// drivers at higher levels to the worklist. Each driver is rebuffered
+// at most once.
+void
+Resizer::rebufferRecheck(bool repair_max_cap,
+			 bool repair_max_slew,
+			 LibertyCell *buffer_cell,
+			 VertexSet &rebuffered,
+			 VertexSet &recheck)
+{
+  VertexSeq drvrs;
+  while (!recheck.empty()) {
+    drvrs.clear();
+    for (auto drvr : recheck) {
+      if (!rebuffered.hasKey(drvr))
+	drvrs.push_back(drvr);
+    }
+    recheck.clear();
+    debugPrint1(debug_, "rebuffer", 1, "recheck %d drivers\n",
+		static_cast<int>(drvrs.size()));
+    // Inserted buffers change levels.
+    ensureLevelized();
+    sort(drvrs, VertexLevelLess(network_));
+    for (auto vertex : drvrs) {
+      if (!isClock(vertex)) {
+	// Only the delays invalidated by rebuffering are recomputed.
+	findDelays(vertex);
+	Pin *drvr_pin = vertex->pin();
+	if ((repair_max_cap
+	     && hasMaxCapViolation(drvr_pin))
+	    || (repair_max_slew
+		&& hasMaxSlewViolation(drvr_pin))) {
+	  RebufferNet *rnet = makeRebufferNet(drvr_pin, buffer_cell);
+	  if (rnet) {
+	    solveRebufferNet(rnet, buffer_cell);
+	    commitRebufferNet(rnet, buffer_cell);
+	    rebuffered.insert(vertex);
+	    findRebufferRecheck(rnet, recheck);
+	    delete rnet;
+	    if (overMaxArea()) {
+	      report_->warn("max utilization reached.\n");
+	      return;
+	    }
+	  }
 	}
       }
     }
   }
 }
 
+void
+Resizer::findFanoutDrvrs(const Pin *drvr_pin,
+			 // Return value.
+			 VertexSet &drvrs)
+{
+  Net *net = network_->net(drvr_pin);
+  if (net) {
+    NetConnectedPinIterator *pin_iter = network_->connectedPinIterator(net);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      if (pin != drvr_pin
+	  && network_->isLoad(pin)
+	  && !network_->isTopLevelPort(pin)) {
+	Instance *inst = network_->instance(pin);
+	InstancePinIterator *inst_pin_iter = network_->pinIterator(inst);
+	while (inst_pin_iter->hasNext()) {
+	  Pin *inst_pin = inst_pin_iter->next();
+	  if (network_->isDriver(inst_pin)) {
+	    Vertex *vertex = graph_->pinDrvrVertex(inst_pin);
+	    if (vertex)
+	      drvrs.insert(vertex);
+	  }
+	}
+	delete inst_pin_iter;
+      }
+    }
+    delete pin_iter;
+  }
+}
+
 bool
 Resizer::hasMaxCapViolation(const Pin *drvr_pin)
 {
@@ -1070,14 +3018,91 @@ Resizer::rebuffer(Net *net,
   PinSet::Iterator drvr_iter(drvrs);
   if (drvr_iter.hasNext()) {
     Pin *drvr = drvr_iter.next();
-    rebuffer(drvr, buffer_cell);
+    RebufferNet *rnet = makeRebufferNet(drvr, buffer_cell);
+    if (rnet) {
+      solveRebufferNet(rnet, buffer_cell);
+      commitRebufferNet(rnet, buffer_cell);
+      rebuffer_drvrs_.clear();
+      delete rnet;
+    }
   }
   report_->print("Inserted %d buffers.\n", inserted_buffer_count_);
 }
 
+RebufferNet::RebufferNet(const Pin *drvr_pin,
+			 Net *net,
+			 LibertyPort *drvr_port,
+			 SteinerTree *tree) :
+  drvr_pin_(drvr_pin),
+  net_(net),
+  drvr_port_(drvr_port),
+  tree_(tree),
+  best_(nullptr),
+  buffer_name_index_(0),
+  net_name_index_(0),
+  name_count_(-1)
+{
+}
+
+RebufferNet::~RebufferNet()
+{
+  options_.deleteContents();
+  delete tree_;
+}
+
 void
-Resizer::rebuffer(const Pin *drvr_pin,
-		  LibertyCell *buffer_cell)
+RebufferNet::reserveNames(NameAllocator &buffer_names,
+			  NameAllocator &net_names)
+{
+  name_count_ = best_ ? best_->bufferCount() : 0;
+  buffer_name_index_ = buffer_names.reserve(name_count_);
+  net_name_index_ = net_names.reserve(name_count_);
+}
+
+void
+RebufferNet::nextNames(// Return values.
+		       int &buffer_index,
+		       int &net_index)
+{
+  buffer_index = buffer_name_index_++;
+  net_index = net_name_index_++;
+  name_count_--;
+}
+
+RebufferOption *
+RebufferNet::makeOption(RebufferOption::Type type,
+			float cap,
+			Required required,
+			Pin *load_pin,
+			DefPt location,
+			RebufferOption *ref,
+			RebufferOption *ref2)
+{
+  RebufferOption *option = new RebufferOption(type, cap, required, load_pin,
+					      location, ref, ref2);
+  options_.push_back(option);
+  return option;
+}
+
+Required
+RebufferNet::loadRequired(const Pin *load_pin) const
+{
+  return load_requireds_.findKey(load_pin);
+}
+
+void
+RebufferNet::setLoadRequired(const Pin *load_pin,
+			     Required required)
+{
+  load_requireds_[load_pin] = required;
+}
+
+// Find the Steiner tree and the load required times, which use the
+// timing graph and cannot be found in parallel.
+// Return nullptr if the net cannot be rebuffered.
+RebufferNet *
+Resizer::makeRebufferNet(const Pin *drvr_pin,
+			 LibertyCell *buffer_cell)
 {
   Net *net;
   LibertyPort *drvr_port;
@@ -1098,32 +3123,152 @@ Resizer::rebuffer(const Pin *drvr_pin,
     LefDefNetwork *network = lefDefNetwork();
     SteinerTree *tree = makeSteinerTree(net, true, network);
     if (tree) {
-      SteinerPt drvr_pt = tree->drvrPt(network_);
       Required drvr_req = pinRequired(drvr_pin);
       // Make sure the driver is constrained.
       if (!fuzzyInf(drvr_req)) {
-	debugPrint1(debug_, "rebuffer", 2, "driver %s\n",
-		    sdc_network_->pathName(drvr_pin));
-	RebufferOptionSeq Z = rebufferBottomUp(tree, tree->left(drvr_pt),
-					       drvr_pt,
-					       1, buffer_cell);
-	Required Tbest = -INF;
-	RebufferOption *best = nullptr;
-	for (auto p : Z) {
-	  Required Tb = p->required() - gateDelay(drvr_port, p->cap());
-	  if (fuzzyGreater(Tb, Tbest)) {
-	    Tbest = Tb;
-	    best = p;
-	  }
-	}
-	if (best) {
-	  int before = inserted_buffer_count_;
-	  rebufferTopDown(best, net, 1, buffer_cell);
-	  if (inserted_buffer_count_ != before)
-	    rebuffer_net_count_++;
+	RebufferNet *rnet = new RebufferNet(drvr_pin, net, drvr_port, tree);
+	for (auto pin : tree->pins()) {
+	  if (network_->isLoad(pin))
+	    rnet->setLoadRequired(pin, pinRequired(pin));
 	}
+	makeGateTableBatches(drvr_port->libertyCell());
+	return rnet;
       }
+      delete tree;
+    }
+  }
+  return nullptr;
+}
+
+// Smaller batches are not worth the thread startup.
+static const size_t rebuffer_thread_net_min = 16;
+
+void
+Resizer::solveRebufferNets(RebufferNetSeq &rnets,
+			   LibertyCell *buffer_cell)
+{
+  size_t net_count = rnets.size();
+  int thread_count = threadCount();
+  // The debug prints share the report and the path name and unit
+  // string buffers, so they are only safe from one thread.
+  if (thread_count <= 1
+      || net_count < rebuffer_thread_net_min
+      || debug_->check("rebuffer", 2)) {
+    for (auto rnet : rnets)
+      solveRebufferNet(rnet, buffer_cell);
+  }
+  else {
+    size_t chunk_size = (net_count + thread_count - 1) / thread_count;
+    Vector<std::thread> threads;
+    for (size_t begin = 0; begin < net_count; begin += chunk_size) {
+      size_t end = min(begin + chunk_size, net_count);
+      threads.push_back(std::thread([=, &rnets] () {
+	    for (size_t i = begin; i < end; i++)
+	      solveRebufferNet(rnets[i], buffer_cell);
+	  }));
+    }
+    for (auto &thread : threads)
+      thread.join();
+  }
+}
+
+// Solve the nets inside each tile on the worker threads and then the
+// nets that cross tiles in one serial pass. rnets is reordered by tile,
+// followed by the nets that cross tiles, so the commit order only
+// depends on the tile count.
+void
+Resizer::solveRebufferTiles(RebufferNetSeq &rnets,
+			    LibertyCell *buffer_cell)
+{
+  Vector<RebufferNetSeq> tile_nets(tile_count_ * tile_count_);
+  RebufferNetSeq boundary_nets;
+  for (auto rnet : rnets) {
+    int tile = netTile(rnet->net());
+    if (tile >= 0)
+      tile_nets[tile].push_back(rnet);
+    else
+      boundary_nets.push_back(rnet);
+  }
+  size_t tile_net_count = rnets.size() - boundary_nets.size();
+  // The debug prints are only safe from one thread.
+  bool parallel = tile_net_count >= rebuffer_thread_net_min
+    && !debug_->check("rebuffer", 2);
+  forEachTile(parallel, [&] (int tile) {
+      for (auto rnet : tile_nets[tile])
+	solveRebufferNet(rnet, buffer_cell);
+    });
+  for (auto rnet : boundary_nets)
+    solveRebufferNet(rnet, buffer_cell);
+  debugPrint1(debug_, "rebuffer", 1, "boundary nets %d\n",
+	      static_cast<int>(boundary_nets.size()));
+
+  rnets.clear();
+  for (auto &nets : tile_nets) {
+    for (auto rnet : nets)
+      rnets.push_back(rnet);
+  }
+  for (auto rnet : boundary_nets)
+    rnets.push_back(rnet);
+}
+
+// Reserve the names of the buffers inserted for each net in commit order.
+void
+Resizer::reserveRebufferNames(RebufferNetSeq &rnets)
+{
+  ensureNameAllocators();
+  for (auto rnet : rnets)
+    rnet->reserveNames(buffer_names_, net_names_);
+}
+
+// Find the best buffering option for the net.
+// Only reads the network, the Steiner tree, the load required times and
+// gate_table_batches_ so nets can be solved concurrently unless
+// rebuffer debugging is on.
+void
+Resizer::solveRebufferNet(RebufferNet *rnet,
+			  LibertyCell *buffer_cell)
+{
+  SteinerTree *tree = rnet->tree();
+  SteinerPt drvr_pt = tree->drvrPt(network_);
+  debugPrint1(debug_, "rebuffer", 2, "driver %s\n",
+	      sdc_network_->pathName(rnet->drvrPin()));
+  RebufferOptionSeq Z = rebufferBottomUp(rnet, tree->left(drvr_pt),
+					 drvr_pt,
+					 1, buffer_cell);
+  FloatSeq load_caps;
+  for (auto p : Z)
+    load_caps.push_back(p->cap());
+  FloatSeq drvr_delays;
+  gateDelays(rnet->drvrPort(), load_caps, drvr_delays);
+  Required Tbest = -INF;
+  RebufferOption *best = nullptr;
+  for (size_t i = 0; i < Z.size(); i++) {
+    RebufferOption *p = Z[i];
+    Required Tb = p->required() - drvr_delays[i];
+    if (fuzzyGreater(Tb, Tbest)) {
+      Tbest = Tb;
+      best = p;
+    }
+  }
+  rnet->setBest(best);
+}
+
+void
+Resizer::commitRebufferNet(RebufferNet *rnet,
+			   LibertyCell *buffer_cell)
+{
+  RebufferOption *best = rnet->best();
+  if (best) {
+    if (!rnet->namesReserved()) {
+      ensureNameAllocators();
+      rnet->reserveNames(buffer_names_, net_names_);
     }
+    int before = inserted_buffer_count_;
+    beginEditBatch();
+    rebufferTopDown(best, rnet, rnet->net(), 1, buffer_cell);
+    commitEditBatch();
+    if (inserted_buffer_count_ != before)
+      rebuffer_net_count_++;
   }
 }
 
@@ -1143,54 +3288,43 @@ Resizer::hasTopLevelOutputPort(Net *net)
   return false;
 }
 
+// Assumes findBufferRequireds() has been called on the options.
 class RebufferOptionBufferReqGreater
 {
 public:
-  RebufferOptionBufferReqGreater(LibertyCell *buffer_cell,
-				 Resizer *resizer);
   bool operator()(RebufferOption *option1,
 		  RebufferOption *option2);
-
-protected:
-  LibertyCell *buffer_cell_;
-  Resizer *resizer_;
 };
 
-RebufferOptionBufferReqGreater::RebufferOptionBufferReqGreater(LibertyCell *buffer_cell,
-							       Resizer *resizer) :
-  buffer_cell_(buffer_cell),
-  resizer_(resizer)
-{
-}
- 
 bool
 RebufferOptionBufferReqGreater::operator()(RebufferOption *option1,
 					   RebufferOption *option2)
 {
-  return fuzzyGreater(option1->bufferRequired(buffer_cell_, resizer_),
-		      option2->bufferRequired(buffer_cell_, resizer_));
+  return fuzzyGreater(option1->bufferRequired(),
+		      option2->bufferRequired());
 }
 
 // The routing tree is represented a binary tree with the sinks being the leaves
 // of the tree, the junctions being the Steiner nodes and the root being the
 // source of the net.
 RebufferOptionSeq
-Resizer::rebufferBottomUp(SteinerTree *tree,
+Resizer::rebufferBottomUp(RebufferNet *rnet,
 			  SteinerPt k,
 			  SteinerPt prev,
 			  int level,
 			  LibertyCell *buffer_cell)
 {
   if (k != SteinerTree::null_pt) {
+    SteinerTree *tree = rnet->tree();
     Pin *pin = tree->pin(k);
     if (pin && network_->isLoad(pin)) {
       // Load capacitance and required time.
-      RebufferOption *z = new RebufferOption(RebufferOption::Type::sink,
-					     pinCapacitance(pin),
-					     pinRequired(pin),
-					     pin,
-					     tree->location(k),
-					     nullptr, nullptr);
+      RebufferOption *z = rnet->makeOption(RebufferOption::Type::sink,
+					   pinCapacitance(pin),
+					   rnet->loadRequired(pin),
+					   pin,
+					   tree->location(k),
+					   nullptr, nullptr);
       // %*s format indents level spaces.
       debugPrint5(debug_, "rebuffer", 3, "%*sload %s cap %s req %s\n",
 		  level, "",
@@ -1199,31 +3333,32 @@ Resizer::rebufferBottomUp(SteinerTree *tree,
 		  delayAsString(z->required(), this));
       RebufferOptionSeq Z;
       Z.push_back(z);
-      return addWireAndBuffer(Z, tree, k, prev, level, buffer_cell);
+      return addWireAndBuffer(Z, rnet, k, prev, level, buffer_cell);
     }
     else if (pin == nullptr) {
       // Steiner pt.
-      RebufferOptionSeq Zl = rebufferBottomUp(tree, tree->left(k), k,
+      RebufferOptionSeq Zl = rebufferBottomUp(rnet, tree->left(k), k,
 					      level + 1, buffer_cell);
-      RebufferOptionSeq Zr = rebufferBottomUp(tree, tree->right(k), k,
+      RebufferOptionSeq Zr = rebufferBottomUp(rnet, tree->right(k), k,
 					      level + 1, buffer_cell);
       RebufferOptionSeq Z;
       // Combine the options from both branches.
       for (auto p : Zl) {
 	for (auto q : Zr) {
-	  RebufferOption *junc = new RebufferOption(RebufferOption::Type::junction,
-						    p->cap() + q->cap(),
-						    min(p->required(),
-							q->required()),
-						    nullptr,
-						    tree->location(k),
-						    p, q);
+	  RebufferOption *junc = rnet->makeOption(RebufferOption::Type::junction,
+						  p->cap() + q->cap(),
+						  min(p->required(),
+						      q->required()),
+						  nullptr,
+						  tree->location(k),
+						  p, q);
 	  Z.push_back(junc);
 	}
       }
       // Prune the options. This is fanout^2.
       // Presort options to hit better options sooner.
-      sort(Z, RebufferOptionBufferReqGreater(buffer_cell, this));
+      findBufferRequireds(Z, buffer_cell);
+      sort(Z, RebufferOptionBufferReqGreater());
       int si = 0;
       for (size_t pi = 0; pi < Z.size(); pi++) {
 	auto p = Z[pi];
@@ -1247,7 +3382,7 @@ Resizer::rebufferBottomUp(SteinerTree *tree,
 	  Z.resize(si);
 	}
       }
-      return addWireAndBuffer(Z, tree, k, prev, level, buffer_cell);
+      return addWireAndBuffer(Z, rnet, k, prev, level, buffer_cell);
     }
   }
   return RebufferOptionSeq();
@@ -1255,13 +3390,14 @@ Resizer::rebufferBottomUp(SteinerTree *tree,
 
 RebufferOptionSeq
 Resizer::addWireAndBuffer(RebufferOptionSeq Z,
-			  SteinerTree *tree,
+			  RebufferNet *rnet,
 			  SteinerPt k,
 			  SteinerPt prev,
 			  int level,
 			  LibertyCell *buffer_cell)
 {
   LefDefNetwork *network = lefDefNetwork();
+  SteinerTree *tree = rnet->tree();
   RebufferOptionSeq Z1;
   Required best = -INF;
   RebufferOption *best_ref = nullptr;
@@ -1274,14 +3410,14 @@ Resizer::addWireAndBuffer(RebufferOptionSeq Z,
   float wire_res = wire_length * wire_res_;
   float wire_delay = wire_res * wire_cap;
   for (auto p : Z) {
-    RebufferOption *z = new RebufferOption(RebufferOption::Type::wire,
-					   // account for wire load
-					   p->cap() + wire_cap,
-					   // account for wire delay
-					   p->required() - wire_delay,
-					   nullptr,
-					   prev_loc,
-					   p, nullptr);
+    RebufferOption *z = rnet->makeOption(RebufferOption::Type::wire,
+					 // account for wire load
+					 p->cap() + wire_cap,
+					 // account for wire delay
+					 p->required() - wire_delay,
+					 nullptr,
+					 prev_loc,
+					 p, nullptr);
     debugPrint7(debug_, "rebuffer", 3, "%*swire %s -> %s wl %d cap %s req %s\n",
 		level, "",
 		tree->name(prev, sdc_network_),
@@ -1290,23 +3426,26 @@ Resizer::addWireAndBuffer(RebufferOptionSeq Z,
 		units_->capacitanceUnit()->asString(z->cap()),
 		delayAsString(z->required(), this));
     Z1.push_back(z);
+  }
+  findBufferRequireds(Z1, buffer_cell);
+  for (auto z : Z1) {
     // We could add options of different buffer drive strengths here
     // Which would have different delay Dbuf and input cap Lbuf
     // for simplicity we only consider one size of buffer.
-    Required rt = z->bufferRequired(buffer_cell, this);
+    Required rt = z->bufferRequired();
     if (fuzzyGreater(rt, best)) {
       best = rt;
-      best_ref = p;
+      best_ref = z->ref();
     }
   }
   if (best_ref) {
-    RebufferOption *z = new RebufferOption(RebufferOption::Type::buffer,
-					   bufferInputCapacitance(buffer_cell),
-					   best,
-					   nullptr,
-					   // Locate buffer at opposite end of wire.
-					   prev_loc,
-					   best_ref, nullptr);
+    RebufferOption *z = rnet->makeOption(RebufferOption::Type::buffer,
+					 bufferInputCapacitance(buffer_cell),
+					 best,
+					 nullptr,
+					 // Locate buffer at opposite end of wire.
+					 prev_loc,
+					 best_ref, nullptr);
     debugPrint7(debug_, "rebuffer", 3, "%*sbuffer %s cap %s req %s -> cap %s req %s\n",
 		level, "",
 		tree->name(prev, sdc_network_),
@@ -1322,6 +3461,7 @@ Resizer::addWireAndBuffer(RebufferOptionSeq Z,
 // Return inserted buffer count.
 void
 Resizer::rebufferTopDown(RebufferOption *choice,
+			 RebufferNet *rnet,
 			 Net *net,
 			 int level,
 			 LibertyCell *buffer_cell)
@@ -1330,15 +3470,14 @@ Resizer::rebufferTopDown(RebufferOption *choice,
   switch(choice->type()) {
   case RebufferOption::Type::buffer: {
     Instance *parent = network->topInstance();
-    string net2_name = makeUniqueNetName();
-    string buffer_name = makeUniqueBufferName();
-    Net *net2 = network->makeNet(net2_name.c_str(), parent);
-    Instance *buffer = network->makeInstance(buffer_cell,
-					     buffer_name.c_str(),
-					     parent);
+    string net2_name, buffer_name;
+    makeRebufferNames(rnet, net2_name, buffer_name);
+    Net *net2 = editMakeNet(net2_name.c_str(), parent);
+    Instance *buffer = editMakeInstance(buffer_cell,
+					buffer_name.c_str(),
+					parent);
     inserted_buffer_count_++;
     design_area_ += network->area(buffer);
-    level_drvr_verticies_valid_ = false;
     LibertyPort *input, *output;
     buffer_cell->bufferPorts(input, output);
     debugPrint5(debug_, "rebuffer", 3, "%*sinsert %s -> %s -> %s\n",
@@ -1346,22 +3485,26 @@ Resizer::rebufferTopDown(RebufferOption *choice,
 		sdc_network_->pathName(net),
 		buffer_name.c_str(),
 		net2_name.c_str());
-    connectPin(buffer, input, net);
-    connectPin(buffer, output, net2);
-    network->setLocation(buffer, choice->location());
-    rebufferTopDown(choice->ref(), net2, level + 1, buffer_cell);
-    makeNetParasitics(net);
-    makeNetParasitics(net2);
+    editConnectPin(buffer, input, net);
+    editConnectPin(buffer, output, net2);
+    updateBufferClock(buffer, net);
+    addLevelDrvrs(buffer);
+    Vertex *buffer_drvr = graph_->pinDrvrVertex(network->findPin(buffer,
+								 output->name()));
+    if (buffer_drvr)
+      rebuffer_drvrs_.push_back(buffer_drvr);
+    editSetLocation(buffer, choice->location());
+    rebufferTopDown(choice->ref(), rnet, net2, level + 1, buffer_cell);
     break;
   }
   case RebufferOption::Type::wire:
     debugPrint2(debug_, "rebuffer", 3, "%*swire\n", level, "");
-    rebufferTopDown(choice->ref(), net, level + 1, buffer_cell);
+    rebufferTopDown(choice->ref(), rnet, net, level + 1, buffer_cell);
     break;
   case RebufferOption::Type::junction: {
     debugPrint2(debug_, "rebuffer", 3, "%*sjunction\n", level, "");
-    rebufferTopDown(choice->ref(), net, level + 1, buffer_cell);
-    rebufferTopDown(choice->ref2(), net, level + 1, buffer_cell);
+    rebufferTopDown(choice->ref(), rnet, net, level + 1, buffer_cell);
+    rebufferTopDown(choice->ref2(), rnet, net, level + 1, buffer_cell);
     break;
   }
   case RebufferOption::Type::sink: {
@@ -1374,31 +3517,103 @@ Resizer::rebufferTopDown(RebufferOption *choice,
 		  level, "",
 		  sdc_network_->pathName(load_pin),
 		  sdc_network_->pathName(net));
-      disconnectPin(load_pin);
-      connectPin(load_inst, load_port, net);
+      editDisconnectPin(load_pin);
+      editConnectPin(load_inst, load_port, net);
     }
     break;
   }
   }
 }
 
+void
+Resizer::setNamePrefixes(const char *buffer_prefix,
+			 const char *net_prefix)
+{
+  // Only a new prefix requires the existing names to be scanned again.
+  if (!stringEq(buffer_prefix, buffer_names_.prefix())) {
+    buffer_names_.setPrefix(buffer_prefix);
+    names_valid_ = false;
+  }
+  if (!stringEq(net_prefix, net_names_.prefix())) {
+    net_names_.setPrefix(net_prefix);
+    names_valid_ = false;
+  }
+}
+
+// Note the existing top level instance and net names once so that
+// allocating a name does not have to search for an unused index.
+// The names are noted again after a new prefix or design.
+void
+Resizer::ensureNameAllocators()
+{
+  LefDefNetwork *network = lefDefNetwork();
+  if (!names_valid_
+      || names_design_epoch_ != network->designEpoch()) {
+    buffer_names_.clear();
+    net_names_.clear();
+    Instance *top_inst = network_->topInstance();
+    InstanceChildIterator *child_iter = network_->childIterator(top_inst);
+    while (child_iter->hasNext()) {
+      Instance *child = child_iter->next();
+      buffer_names_.noteName(network_->name(child));
+    }
+    delete child_iter;
+
+    NetIterator *net_iter = network_->netIterator(top_inst);
+    while (net_iter->hasNext()) {
+      Net *net = net_iter->next();
+      net_names_.noteName(network_->name(net));
+    }
+    delete net_iter;
+    names_valid_ = true;
+    names_design_epoch_ = network->designEpoch();
+  }
+}
+
 string
 Resizer::makeUniqueNetName()
 {
-  string node_name;
+  ensureNameAllocators();
+  string net_name;
   Instance *top_inst = network_->topInstance();
-  do 
-    stringPrint(node_name, "net%d", unique_net_index_++);
-  while (network_->findNet(top_inst, node_name.c_str()));
-  return node_name;
+  // Only names made by someone else since the scan can collide.
+  do
+    net_name = net_names_.makeName();
+  while (network_->findNet(top_inst, net_name.c_str()));
+  return net_name;
+}
+
+// Use the names reserved for rnet unless something else
+// has made an object with the same name since the scan.
+void
+Resizer::makeRebufferNames(RebufferNet *rnet,
+			   // Return values.
+			   string &net_name,
+			   string &buffer_name)
+{
+  if (rnet->hasReservedNames()) {
+    int buffer_index, net_index;
+    rnet->nextNames(buffer_index, net_index);
+    net_name = net_names_.name(net_index);
+    buffer_name = buffer_names_.name(buffer_index);
+    if (network_->findNet(network_->topInstance(), net_name.c_str()))
+      net_name = makeUniqueNetName();
+    if (network_->findInstance(buffer_name.c_str()))
+      buffer_name = makeUniqueBufferName();
+  }
+  else {
+    net_name = makeUniqueNetName();
+    buffer_name = makeUniqueBufferName();
+  }
 }
 
 string
 Resizer::makeUniqueBufferName()
 {
+  ensureNameAllocators();
   string buffer_name;
-  do 
-    stringPrint(buffer_name, "buffer%d", unique_buffer_index_++);
+  do
+    buffer_name = buffer_names_.makeName();
   while (network_->findInstance(buffer_name.c_str()));
   return buffer_name;
 }
@@ -1467,10 +3682,58 @@ Resizer::bufferDelay(LibertyCell *buffer_cell,
 float
 Resizer::gateDelay(LibertyPort *out_port,
 		   float load_cap)
+{
+  FloatSeq load_caps(1, load_cap);
+  FloatSeq delays;
+  gateDelays(out_port, load_caps, delays);
+  return delays[0];
+}
+
+// Max rise/fall delay and slew using the input slews instead of the
+// target slews.
+void
+Resizer::gateDelay(LibertyPort *out_port,
+		   const Slew in_slews[],
+		   float load_cap,
+		   // Return values.
+		   float &delay,
+		   float &slew)
+{
+  LibertyCell *cell = out_port->libertyCell();
+  delay = -INF;
+  slew = 0.0;
+  LibertyCellTimingArcSetIterator set_iter(cell);
+  while (set_iter.hasNext()) {
+    TimingArcSet *arc_set = set_iter.next();
+    if (arc_set->to() == out_port) {
+      TimingArcSetArcIterator arc_iter(arc_set);
+      while (arc_iter.hasNext()) {
+	TimingArc *arc = arc_iter.next();
+	TransRiseFall *in_tr = arc->fromTrans()->asRiseFall();
+	float in_slew = delayAsFloat(in_slews[in_tr->index()]);
+	GateTableBatch *batch = gateTableBatch(cell, arc);
+	float arc_delay, arc_slew;
+	batch->gateDelay(in_slew, load_cap, arc_delay, arc_slew);
+	delay = max(delay, arc_delay);
+	slew = max(slew, arc_slew);
+      }
+    }
+  }
+}
+
+void
+Resizer::gateDelays(LibertyPort *out_port,
+		    const FloatSeq &load_caps,
+		    // Return values.
+		    FloatSeq &delays)
 {
   LibertyCell *cell = out_port->libertyCell();
+  size_t count = load_caps.size();
   // Max rise/fall delays.
-  ArcDelay max_delay = -INF;
+  delays.clear();
+  delays.resize(count, -INF);
+  FloatSeq in_slews(count);
+  FloatSeq arc_delays, arc_slews;
   LibertyCellTimingArcSetIterator set_iter(cell);
   while (set_iter.hasNext()) {
     TimingArcSet *arc_set = set_iter.next();
@@ -1480,17 +3743,93 @@ Resizer::gateDelay(LibertyPort *out_port,
 	TimingArc *arc = arc_iter.next();
 	TransRiseFall *in_tr = arc->fromTrans()->asRiseFall();
 	float in_slew = tgt_slews_[in_tr->index()];
-	ArcDelay gate_delay;
-	Slew drvr_slew;
-	arc_delay_calc_->gateDelay(cell, arc, in_slew, load_cap,
-				   nullptr, 0.0, pvt_, dcalc_ap_,
-				   gate_delay,
-				   drvr_slew);
-	max_delay = max(max_delay, gate_delay);
+	in_slews.assign(count, in_slew);
+	GateTableBatch *batch = gateTableBatch(cell, arc);
+	batch->gateDelays(in_slews, load_caps, arc_delays, arc_slews);
+	for (size_t i = 0; i < count; i++)
+	  delays[i] = max(delays[i], arc_delays[i]);
+      }
+    }
+  }
+}
+
+// Set the required time at the input of a buffer driving each option.
+void
+Resizer::findBufferRequireds(RebufferOptionSeq &options,
+			     LibertyCell *buffer_cell)
+{
+  LibertyPort *input, *output;
+  buffer_cell->bufferPorts(input, output);
+  FloatSeq load_caps;
+  for (auto option : options)
+    load_caps.push_back(option->cap());
+  FloatSeq delays;
+  gateDelays(output, load_caps, delays);
+  for (size_t i = 0; i < options.size(); i++) {
+    RebufferOption *option = options[i];
+    option->setBufferRequired(option->required() - delays[i]);
+  }
+}
+
+GateTableBatch *
+Resizer::gateTableBatch(LibertyCell *cell,
+			TimingArc *arc)
+{
+  GateTableBatch *batch = gate_table_batches_.findKey(arc);
+  if (batch == nullptr) {
+    batch = new GateTableBatch(cell, arc, pvt_);
+    gate_table_batches_[arc] = batch;
+  }
+  return batch;
+}
+
+// Largest difference between the batched and scalar gate models of
+// cell over a grid of slews and loads that extends past the table
+// axes, relative to the scalar value (floored at 1ps).
+// Return -1 if some arc of cell is not batched.
+float
+Resizer::tableBatchError(LibertyCell *cell)
+{
+  ensureCorner();
+  static const float slew_samples[] = {0.0, 5e-12, 1e-11, 5e-11, 1e-10,
+				       5e-10, 1e-9, 2e-9, 5e-9};
+  static const float cap_samples[] = {0.0, 5e-16, 1e-15, 5e-15, 1e-14,
+				      5e-14, 1e-13, 2e-13, 5e-13};
+  FloatSeq in_slews, load_caps;
+  for (auto in_slew : slew_samples) {
+    for (auto load_cap : cap_samples) {
+      in_slews.push_back(in_slew);
+      load_caps.push_back(load_cap);
+    }
+  }
+  float error = 0.0;
+  FloatSeq delays, slews;
+  LibertyCellTimingArcSetIterator set_iter(cell);
+  while (set_iter.hasNext()) {
+    TimingArcSet *arc_set = set_iter.next();
+    TimingArcSetArcIterator arc_iter(arc_set);
+    while (arc_iter.hasNext()) {
+      TimingArc *arc = arc_iter.next();
+      GateTimingModel *model = dynamic_cast<GateTimingModel*>(arc->model());
+      if (model) {
+	GateTableBatch *batch = gateTableBatch(cell, arc);
+	if (!batch->isBatched())
+	  return -1.0;
+	batch->gateDelays(in_slews, load_caps, delays, slews);
+	for (size_t i = 0; i < in_slews.size(); i++) {
+	  ArcDelay delay;
+	  Slew slew;
+	  model->gateDelay(cell, pvt_, in_slews[i], load_caps[i], 0.0, false,
+			   delay, slew);
+	  float delay1 = delayAsFloat(delay);
+	  float slew1 = delayAsFloat(slew);
+	  error = max(error, abs(delays[i] - delay1) / max(abs(delay1), 1e-12F));
+	  error = max(error, abs(slews[i] - slew1) / max(abs(slew1), 1e-12F));
+	}
       }
     }
   }
-  return max_delay;
+  return error;
 }
 
 double
@@ -1503,4 +3842,629 @@ Resizer::designArea()
   return design_area_;
 }
 
+
+////////////////////////////////////////////////////////////////
+
+class InstanceLocationLess
+{
+public:
+  InstanceLocationLess(const LefDefNetwork *network);
+  bool operator()(Instance *inst1,
+		  Instance *inst2) const;
+
+protected:
+  DefPt location(Instance *inst) const;
+
+  const LefDefNetwork *network_;
+};
+
+InstanceLocationLess::InstanceLocationLess(const LefDefNetwork *network) :
+  network_(network)
+{
+}
+
+bool
+InstanceLocationLess::operator()(Instance *inst1,
+				 Instance *inst2) const
+{
+  DefPt loc1 = location(inst1);
+  DefPt loc2 = location(inst2);
+  return loc1.x() < loc2.x()
+    || (loc1.x() == loc2.x()
+	&& (loc1.y() < loc2.y()
+	    || (loc1.y() == loc2.y()
+		// Break ties for stable results.
+		&& stringLess(network_->pathName(inst1),
+			      network_->pathName(inst2)))));
+}
+
+// Unplaced components sort to the origin.
+DefPt
+InstanceLocationLess::location(Instance *inst) const
+{
+  const DefPlacement *placement = network_->placement(inst);
+  if (placement && placement->isPlaced())
+    return placement->location();
+  else
+    return DefPt(0, 0);
+}
+
+void
+Resizer::writeDefShards(const char *dirname,
+			int shard_count,
+			bool sort,
+			bool write_sdc)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  if (network->defFilename() == nullptr) {
+    report_->printError("Error: DEF shards require a design read with read_def.\n");
+    return;
+  }
+  // Only the port constraints need the timing graph and parasitics.
+  if (write_sdc) {
+    init();
+    findRequireds();
+  }
+
+  InstanceSeq insts;
+  LeafInstanceIterator *leaf_iter = network->leafInstanceIterator();
+  while (leaf_iter->hasNext()) {
+    Instance *inst = leaf_iter->next();
+    insts.push_back(inst);
+  }
+  delete leaf_iter;
+  sta::sort(insts, InstanceLocationLess(network));
+
+  size_t inst_count = insts.size();
+  size_t shard_size = (inst_count + shard_count - 1) / shard_count;
+  int shard_index = 0;
+  for (size_t begin = 0; begin < inst_count; begin += shard_size) {
+    size_t end = min(begin + shard_size, inst_count);
+    InstanceSeq shard_insts(insts.begin() + begin, insts.begin() + end);
+    DefShard shard(shard_insts, network);
+    string def_filename;
+    stringPrint(def_filename, "%s/shard%d.def", dirname, shard_index);
+    writeDefShard(def_filename.c_str(), &shard, sort, network);
+    if (write_sdc) {
+      string sdc_filename;
+      stringPrint(sdc_filename, "%s/shard%d.sdc", dirname, shard_index);
+      writeShardSdc(sdc_filename.c_str(), &shard);
+    }
+    debugPrint3(debug_, "shard", 1, "shard%d %d components %d ports\n",
+		shard_index,
+		static_cast<int>(shard_insts.size()),
+		static_cast<int>(shard.ports().size()));
+    shard_index++;
+  }
+  report_->print("Wrote %d shards.\n", shard_index);
+}
+
+// Shard ports are constrained relative to the fastest clock in the
+// design. Ports on clock nets define it.
+void
+Resizer::writeShardSdc(const char *filename,
+		       const DefShard *shard)
+{
+  FILE *stream = fopen(filename, "w");
+  if (stream == nullptr)
+    throw FileNotWritable(filename);
+  const Unit *time_unit = units_->timeUnit();
+  const Unit *cap_unit = units_->capacitanceUnit();
+  int digits = 6;
+
+  Clock *clk = nullptr;
+  ClockIterator *clk_iter = sdc_->clockIterator();
+  while (clk_iter->hasNext()) {
+    Clock *clk1 = clk_iter->next();
+    if (clk == nullptr || clk1->period() < clk->period())
+      clk = clk1;
+  }
+  delete clk_iter;
+
+  const DefShardPortSeq &ports = shard->ports();
+  if (clk) {
+    fprintf(stream, "create_clock -name %s -period %s",
+	    clk->name(),
+	    time_unit->asString(clk->period(), digits));
+    fprintf(stream, " [get_ports -quiet {");
+    for (auto &port : ports) {
+      if (isClock(port.net()))
+	fprintf(stream, " %s", port.name());
+    }
+    fprintf(stream, " }]\n");
+  }
+
+  for (auto &port : ports) {
+    Net *net = port.net();
+    Pin *outside_pin = port.outsidePin();
+    if (isClock(net) || outside_pin == nullptr)
+      continue;
+    if (port.direction()->isInput()) {
+      Vertex *drvr_vertex = graph_->pinDrvrVertex(outside_pin);
+      if (clk) {
+	Arrival arrival = vertexArrival(drvr_vertex, min_max_);
+	if (!fuzzyInf(arrival))
+	  fprintf(stream, "set_input_delay -clock %s %s [get_ports {%s}]\n",
+		  clk->name(),
+		  time_unit->asString(delayAsFloat(arrival), digits),
+		  port.name());
+      }
+      Slew slew = 0.0;
+      for (auto tr : TransRiseFall::range())
+	slew = max(slew, graph_->slew(drvr_vertex, tr, dcalc_ap_->index()));
+      fprintf(stream, "set_input_transition %s [get_ports {%s}]\n",
+	      time_unit->asString(delayAsFloat(slew), digits),
+	      port.name());
+    }
+    else {
+      if (clk) {
+	Required required = pinRequired(outside_pin);
+	if (!fuzzyInf(required))
+	  fprintf(stream, "set_output_delay -clock %s %s [get_ports {%s}]\n",
+		  clk->name(),
+		  time_unit->asString(clk->period() - delayAsFloat(required),
+				      digits),
+		  port.name());
+      }
+      float load_cap = 0.0;
+      NetConnectedPinIterator *pin_iter = network_->connectedPinIterator(net);
+      while (pin_iter->hasNext()) {
+	Pin *pin = pin_iter->next();
+	if (network_->isLoad(pin)
+	    && !network_->isTopLevelPort(pin)
+	    && !shard->hasInstance(network_->instance(pin)))
+	  load_cap += pinCapacitance(pin);
+      }
+      delete pin_iter;
+      fprintf(stream, "set_load %s [get_ports {%s}]\n",
+	      cap_unit->asString(load_cap, digits),
+	      port.name());
+    }
+  }
+  // A full disk only shows up as a write or close error.
+  bool error = ferror(stream) != 0;
+  error |= fclose(stream) != 0;
+  if (error)
+    throw FileNotWritable(filename);
+}
+
+void
+Resizer::mergeDefShard(const char *shard_filename,
+		       const char *resized_filename,
+		       const char *prefix)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  DefShardContents shard, resized;
+  readDefShard(shard_filename, report_, shard);
+  readDefShard(resized_filename, report_, resized);
+
+  Set<string> shard_insts, shard_nets;
+  for (auto &component : shard.components_)
+    shard_insts.insert(component.name_);
+  for (auto &net : shard.nets_)
+    shard_nets.insert(net.name_);
+
+  Library *lef_lib = network->lefLibrary();
+  Instance *top_inst = network->topInstance();
+  int edit_count = resized.components_.size() + shard.components_.size();
+  for (auto &resized_net : resized.nets_)
+    edit_count += resized_net.connections_.size() * 2;
+  // The batch estimates the parasitics of the changed nets.
+  beginEditBatch(edit_count);
+  Map<string, Instance*> inst_map;
+  InstanceSeq new_insts;
+  Set<string> resized_insts;
+  int replace_count = 0;
+  int insert_count = 0;
+  for (auto &component : resized.components_) {
+    resized_insts.insert(component.name_);
+    Cell *cell = network->findCell(lef_lib, component.macro_.c_str());
+    if (cell == nullptr) {
+      report_->printError("Error: component %s macro %s not found.\n",
+			  component.name_.c_str(),
+			  component.macro_.c_str());
+      continue;
+    }
+    Instance *inst;
+    if (shard_insts.hasKey(component.name_)) {
+      inst = network->findInstance(component.name_.c_str());
+      if (inst && network->cell(inst) != cell) {
+	editReplaceCell(inst, cell);
+	replace_count++;
+      }
+    }
+    else {
+      string inst_name = prefix + component.name_;
+      inst = editMakeInstance(cell, inst_name.c_str(), top_inst);
+      if (component.is_placed_)
+	editSetLocation(inst, component.location_);
+      new_insts.push_back(inst);
+      insert_count++;
+    }
+    if (inst)
+      inst_map[component.name_] = inst;
+  }
+  for (auto &component : shard.components_) {
+    if (!resized_insts.hasKey(component.name_)) {
+      Instance *inst = network->findInstance(component.name_.c_str());
+      if (inst) {
+	removeLevelDrvrs(inst);
+	editDeleteInstance(inst);
+      }
+    }
+  }
+
+  for (auto &resized_net : resized.nets_) {
+    Net *net;
+    if (shard_nets.hasKey(resized_net.name_))
+      net = network->findNet(resized_net.name_.c_str());
+    else {
+      string net_name = prefix + resized_net.name_;
+      net = editMakeNet(net_name.c_str(), top_inst);
+    }
+    if (net == nullptr)
+      continue;
+    for (auto &connection : resized_net.connections_) {
+      // Shard ports stand in for the rest of the design.
+      if (connection.inst_name_ == "PIN")
+	continue;
+      Instance *inst = inst_map.findKey(connection.inst_name_);
+      if (inst) {
+	Port *port = network->findPort(network->cell(inst),
+				       connection.port_name_.c_str());
+	if (port) {
+	  Pin *pin = network->findPin(inst, port);
+	  if (pin == nullptr || network->net(pin) != net) {
+	    if (pin)
+	      editDisconnectPin(pin);
+	    editConnectPin(inst, port, net);
+	  }
+	}
+      }
+    }
+  }
+
+  for (auto inst : new_insts)
+    addLevelDrvrs(inst);
+  commitEditBatch();
+  clk_vertices_valid_ = false;
+  ensureClkVertices();
+  names_valid_ = false;
+  design_area_ = network->designArea();
+  report_->print("Merged %s: %d resized, %d inserted.\n",
+		 resized_filename,
+		 replace_count,
+		 insert_count);
+}
+
+////////////////////////////////////////////////////////////////
+
+// Session layout: header, libraries, network, resizer state and
+// optional parasitics.
+bool
+Resizer::writeSession(const char *filename,
+		      bool parasitics)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  if (network->lefLibrary() == nullptr
+      || network->topInstance() == nullptr) {
+    report_->printError("Error: no design to write.\n");
+    return false;
+  }
+  SessionWriter writer(filename);
+  writer.writeHeader();
+  writeSessionLibraries(writer);
+  writeSessionNetwork(writer, network);
+  writeSessionState(writer);
+  writer.writeBool(parasitics);
+  if (parasitics)
+    writeSessionParasitics(writer);
+  writer.close();
+  return true;
+}
+
+bool
+Resizer::readSession(const char *filename)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  if (network->topInstance()) {
+    report_->printError("Error: read_session requires an empty design.\n");
+    return false;
+  }
+  SessionReader reader(filename);
+  if (!reader.readHeader()) {
+    report_->printError("Error: %s is not a version %u session.\n",
+			filename,
+			session_version);
+    return false;
+  }
+  if (!readSessionLibraries(reader)
+      || !readSessionNetwork(reader, network)) {
+    report_->printError("Error: session %s is damaged.\n", filename);
+    return false;
+  }
+  static_cast<LefDefSdcNetwork*>(sdc_network_)->clear();
+  names_valid_ = false;
+  level_drvr_verticies_valid_ = false;
+  clk_vertices_valid_ = false;
+  readSessionState(reader);
+  if (reader.readBool())
+    readSessionParasitics(reader);
+  else if (wire_res_ != 0.0 || wire_cap_ != 0.0) {
+    ensureGraph();
+    ensureClkVertices();
+    makeNetParasitics();
+  }
+  if (reader.error()) {
+    report_->printError("Error: session %s is damaged.\n", filename);
+    return false;
+  }
+  return true;
+}
+
+void
+Resizer::writeSessionLibraries(SessionWriter &writer)
+{
+  LibertyLibrarySeq libs;
+  LibertyLibraryIterator *lib_iter = network_->libertyLibraryIterator();
+  while (lib_iter->hasNext())
+    libs.push_back(lib_iter->next());
+  delete lib_iter;
+  writer.writeUInt(libs.size());
+  for (auto lib : libs)
+    writer.writeString(lib->filename());
+  ConcreteLibrary *lef_clib =
+    reinterpret_cast<ConcreteLibrary*>(lefDefNetwork()->lefLibrary());
+  writer.writeString(lef_clib->filename());
+}
+
+// The libraries are referenced by filename and only read if no LEF
+// library has been read, so a session can also be read on top of
+// libraries read by the script.
+bool
+Resizer::readSessionLibraries(SessionReader &reader)
+{
+  Vector<string> liberty_files;
+  uint32_t lib_count = reader.readUInt();
+  for (uint32_t i = 0; i < lib_count && !reader.error(); i++)
+    liberty_files.push_back(reader.readString());
+  string lef_filename = reader.readString();
+  LefDefNetwork *network = lefDefNetwork();
+  if (network->lefLibrary() == nullptr
+      && !reader.error()) {
+    StringSeq liberty_filenames;
+    for (const string &filename : liberty_files)
+      liberty_filenames.push_back(filename.c_str());
+    readDesignFiles(&liberty_filenames,
+		    lef_filename.empty() ? nullptr : lef_filename.c_str(),
+		    nullptr);
+  }
+  return !reader.error()
+    && network->lefLibrary();
+}
+
+static void
+writeSessionCell(SessionWriter &writer,
+		 LibertyCell *cell)
+{
+  writer.writeString(cell->libertyLibrary()->name());
+  writer.writeString(cell->name());
+}
+
+static LibertyCell *
+readSessionCell(SessionReader &reader,
+		Network *network)
+{
+  string lib_name = reader.readString();
+  string cell_name = reader.readString();
+  LibertyLibrary *lib = network->findLiberty(lib_name.c_str());
+  if (lib)
+    return lib->findLibertyCell(cell_name.c_str());
+  else
+    return nullptr;
+}
+
+void
+Resizer::writeSessionState(SessionWriter &writer)
+{
+  writer.writeFloat(wire_res_);
+  writer.writeFloat(wire_cap_);
+  writer.writeString(corner_ ? corner_->name() : "");
+  writer.writeDouble(die_lx_);
+  writer.writeDouble(die_ly_);
+  writer.writeDouble(die_ux_);
+  writer.writeDouble(die_uy_);
+  writer.writeDouble(core_lx_);
+  writer.writeDouble(core_ly_);
+  writer.writeDouble(core_ux_);
+  writer.writeDouble(core_uy_);
+  writer.writeDouble(max_area_);
+  writer.writeDouble(design_area_);
+  writer.writeString(buffer_names_.prefix());
+  writer.writeString(net_names_.prefix());
+
+  writer.writeUInt(dont_use_.size());
+  for (auto cell : dont_use_)
+    writeSessionCell(writer, cell);
+
+  for (auto tr_index : TransRiseFall::rangeIndex())
+    writer.writeFloat(tgt_slews_[tr_index]);
+  if (target_load_map_) {
+    writer.writeUInt(target_load_libs_.size());
+    for (auto lib : target_load_libs_)
+      writer.writeString(lib->name());
+    writer.writeUInt(target_load_map_->size());
+    for (auto cell_load : *target_load_map_) {
+      writeSessionCell(writer, cell_load.first);
+      writer.writeFloat(cell_load.second);
+    }
+  }
+  else {
+    writer.writeUInt(0);
+    writer.writeUInt(0);
+  }
+}
+
+void
+Resizer::readSessionState(SessionReader &reader)
+{
+  wire_res_ = reader.readFloat();
+  wire_cap_ = reader.readFloat();
+  string corner_name = reader.readString();
+  Corner *corner = findCorner(corner_name.c_str());
+  initCorner(corner ? corner : cmd_corner_);
+  double die_lx = reader.readDouble();
+  double die_ly = reader.readDouble();
+  double die_ux = reader.readDouble();
+  double die_uy = reader.readDouble();
+  setDieSize(die_lx, die_ly, die_ux, die_uy);
+  double core_lx = reader.readDouble();
+  double core_ly = reader.readDouble();
+  double core_ux = reader.readDouble();
+  double core_uy = reader.readDouble();
+  setCoreSize(core_lx, core_ly, core_ux, core_uy);
+  max_area_ = reader.readDouble();
+  design_area_ = reader.readDouble();
+  string buffer_prefix = reader.readString();
+  string net_prefix = reader.readString();
+  setNamePrefixes(buffer_prefix.c_str(), net_prefix.c_str());
+
+  uint32_t dont_use_count = reader.readUInt();
+  for (uint32_t i = 0; i < dont_use_count && !reader.error(); i++) {
+    LibertyCell *cell = readSessionCell(reader, network_);
+    if (cell)
+      dont_use_.insert(cell);
+  }
+
+  for (auto tr_index : TransRiseFall::rangeIndex())
+    tgt_slews_[tr_index] = reader.readFloat();
+  // The target loads are only used if all of their libraries are found.
+  LibertyLibrarySeq libs;
+  bool libs_found = true;
+  uint32_t lib_count = reader.readUInt();
+  for (uint32_t i = 0; i < lib_count && !reader.error(); i++) {
+    string lib_name = reader.readString();
+    LibertyLibrary *lib = network_->findLiberty(lib_name.c_str());
+    if (lib)
+      libs.push_back(lib);
+    else
+      libs_found = false;
+  }
+  uint32_t load_count = reader.readUInt();
+  if (load_count > 0 && target_load_map_ == nullptr)
+    target_load_map_ = new CellTargetLoadMap;
+  for (uint32_t i = 0; i < load_count && !reader.error(); i++) {
+    LibertyCell *cell = readSessionCell(reader, network_);
+    float load = reader.readFloat();
+    if (cell)
+      (*target_load_map_)[cell] = load;
+  }
+  if (libs_found && load_count > 0)
+    target_load_libs_ = libs;
+}
+
+// The wire segments of the Steiner trees are saved so reading the
+// session does not have to rebuild the trees.
+void
+Resizer::writeSessionParasitics(SessionWriter &writer)
+{
+  NetSeq nets;
+  if (wire_res_ != 0.0 || wire_cap_ != 0.0) {
+    ensureGraph();
+    ensureClkVertices();
+    NetIterator *net_iter = network_->netIterator(network_->topInstance());
+    while (net_iter->hasNext()) {
+      Net *net = net_iter->next();
+      // Hands off the clock nets.
+      if (!isClock(net))
+	nets.push_back(net);
+    }
+    delete net_iter;
+  }
+  writer.writeUInt(nets.size());
+  ParasiticSegmentSeq segments;
+  for (auto net : nets) {
+    segments.clear();
+    findNetWireSegments(net, segments);
+    writer.writeString(network_->name(net));
+    writer.writeUInt(segments.size());
+    for (const ParasiticSegment &segment : segments) {
+      writer.writeString(segment.pin1_ ? network_->pathName(segment.pin1_) : "");
+      writer.writeInt(segment.steiner_pt1_);
+      writer.writeString(segment.pin2_ ? network_->pathName(segment.pin2_) : "");
+      writer.writeInt(segment.steiner_pt2_);
+      writer.writeFloat(segment.res_);
+      writer.writeFloat(segment.cap_);
+    }
+  }
+}
+
+void
+Resizer::readSessionParasitics(SessionReader &reader)
+{
+  Instance *top_inst = network_->topInstance();
+  ParasiticSegmentSeq segments;
+  uint32_t net_count = reader.readUInt();
+  for (uint32_t i = 0; i < net_count && !reader.error(); i++) {
+    string net_name = reader.readString();
+    Net *net = network_->findNet(top_inst, net_name.c_str());
+    segments.clear();
+    uint32_t segment_count = reader.readUInt();
+    for (uint32_t j = 0; j < segment_count && !reader.error(); j++) {
+      string pin_name1 = reader.readString();
+      int steiner_pt1 = reader.readInt();
+      string pin_name2 = reader.readString();
+      int steiner_pt2 = reader.readInt();
+      float res = reader.readFloat();
+      float cap = reader.readFloat();
+      const Pin *pin1 = pin_name1.empty()
+	? nullptr
+	: network_->findPin(pin_name1.c_str());
+      const Pin *pin2 = pin_name2.empty()
+	? nullptr
+	: network_->findPin(pin_name2.c_str());
+      segments.push_back(ParasiticSegment{pin1, steiner_pt1,
+					  pin2, steiner_pt2,
+					  res, cap});
+    }
+    if (net && !reader.error())
+      makeNetParasitics(net, segments);
+  }
+}
+
+void
+Resizer::setSessionCheckpoint(const char *filename,
+			      double interval)
+{
+  session_checkpoint_filename_ = filename ? filename : "";
+  session_checkpoint_interval_ = interval;
+  session_checkpoint_time_ = std::chrono::steady_clock::now();
+}
+
+// Called between resizing steps when the network is consistent.
+// Parasitics are not written so checkpoints stay cheap; they are
+// estimated again when the session is read.
+void
+Resizer::writeSessionCheckpoint()
+{
+  if (!session_checkpoint_filename_.empty()) {
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - session_checkpoint_time_;
+    if (elapsed.count() >= session_checkpoint_interval_) {
+      // Write to a temporary file so an interrupted write does not
+      // clobber the previous checkpoint.
+      // Write errors throw before the rename.
+      string tmp_filename = session_checkpoint_filename_ + ".tmp";
+      if (writeSession(tmp_filename.c_str(), false)) {
+	if (rename(tmp_filename.c_str(),
+		   session_checkpoint_filename_.c_str()) != 0)
+	  throw FileNotWritable(session_checkpoint_filename_.c_str());
+	debugPrint1(debug_, "resizer", 1, "checkpoint %s\n",
+		    session_checkpoint_filename_.c_str());
+      }
+      session_checkpoint_time_ = std::chrono::steady_clock::now();
+    }
+  }
+}
+
 }
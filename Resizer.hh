@@ -17,26 +17,74 @@
 #ifndef RESIZER_RESIZER_H
 #define RESIZER_RESIZER_H
 
+#include <chrono>
+#include <functional>
+#include "StringSeq.hh"
 #include "Sta.hh"
 #include "SteinerTree.hh"
+#include "TableBatch.hh"
+#include "NameAllocator.hh"
 
 namespace sta {
 
 class LefDefNetwork;
+class DefShard;
+class DefSkip;
 class RebufferOption;
+class RebufferNet;
+class EditJournal;
+class EditJournalEntry;
+class LrGate;
+class SessionWriter;
+class SessionReader;
 
 typedef Map<LibertyCell*, float> CellTargetLoadMap;
 typedef Vector<RebufferOption*> RebufferOptionSeq;
+typedef Vector<RebufferNet*> RebufferNetSeq;
+typedef Vector<EditJournalEntry> EditJournalEntrySeq;
+typedef Vector<LrGate*> LrGateSeq;
+
+// Wire between two parasitic nodes of a net. A node is a pin or,
+// when the pin is null, a steiner point.
+class ParasiticSegment
+{
+public:
+  const Pin *pin1_;
+  int steiner_pt1_;
+  const Pin *pin2_;
+  int steiner_pt2_;
+  float res_;
+  float cap_;
+};
+typedef Vector<ParasiticSegment> ParasiticSegmentSeq;
 
 class Resizer : public Sta
 {
 public:
   Resizer();
+  virtual ~Resizer();
+  // Table batches and target loads refer to the library timing arcs,
+  // so they are deleted when a library is read.
+  virtual LibertyLibrary *readLiberty(const char *filename,
+				      Corner *corner,
+				      const MinMaxAll *min_max,
+				      bool infer_latches);
   LefDefNetwork *lefDefNetwork();
   const LefDefNetwork *lefDefNetwork() const;
   void initFlute(const char *resizer_path);
 
-  void readDef(const char *filename);
+  // Use the fast DEF reader with fast.
+  void readDef(const char *filename,
+	       const DefSkip &skip,
+	       bool fast);
+  // Parse liberty files into detached libraries on a worker thread
+  // while the LEF and DEF files are read. The libraries are added to
+  // the network and LEF macros are linked to liberty cells on the
+  // calling thread after all of the files are read.
+  // Null file names are skipped.
+  void readDesignFiles(StringSeq *liberty_files,
+		       const char *lef_filename,
+		       const char *def_filename);
 
   // Set the resistance and capacitance used for parasitics.
   // Make net wire parasitics based on DEF locations.
@@ -75,15 +123,83 @@ public:
   void init();
   void setDontUse(LibertyCellSeq *dont_use);
   void setMaxUtilization(double max_utilization);
+  // Split the core area into a tile_count x tile_count grid of tiles.
+  // Nets with all of their pins inside one tile are resized and
+  // rebuffered by worker threads a tile at a time; nets that cross
+  // tiles are done serially afterwards. 0 or 1 disables tiling.
+  void setTileCount(int tile_count);
   void resizePreamble(LibertyLibrarySeq *resize_libs);
+  // Prefixes for the names of inserted buffers and nets.
+  void setNamePrefixes(const char *buffer_prefix,
+		       const char *net_prefix);
+  // Network edits made between beginEditBatch and commitEditBatch are
+  // committed together. edit_count is the expected number of edits.
+  // Batches that edit a large part of the design only edit the network
+  // and the graph is rebuilt by commitEditBatch; timing is invalid inside
+  // them and graph vertices found before them are invalid after them.
+  // Smaller batches update the graph incrementally. Callers that use
+  // graph vertices across the batch pass no edit count.
+  // The commit estimates the parasitics of the nets the batch touched.
+  // Batches nest; the outermost batch chooses the mode and commits.
+  void beginEditBatch(int edit_count = 0);
+  void commitEditBatch();
+  // Record the network edits made by buffering, rebuffering and
+  // resizing so they can be undone by rollbackEdits. A new checkpoint
+  // discards the edits recorded since the previous one.
+  void checkpointEdits();
+  // Undo the edits since the checkpoint, including the parasitics of
+  // the changed nets, the design area, the inserted buffer and resize
+  // counts and the allocated names, and stop recording.
+  void rollbackEdits();
+  // Keep the edits since the checkpoint and stop recording.
+  void acceptEdits();
+  bool haveEditCheckpoint() const;
   void bufferInputs(LibertyCell *buffer_cell);
   void bufferOutputs(LibertyCell *buffer_cell);
   // Resize all instances in the network.
+  // Drivers whose loads change because a fanout instance was resized
+  // are revisited until nothing is resized or max_iterations passes
+  // have been made.
   // resizerPreamble() required.
-  void resizeToTargetSlew();
+  void resizeToTargetSlew(int max_iterations);
   // Resize inst to target slew (for testing).
+  // Return true if the instance cell was changed.
+  // resizerPreamble() required.
+  bool resizeToTargetSlew(Instance *inst);
+  // Resize to minimize area subject to the timing constraints using
+  // Lagrangian relaxation. Gates are resized until no gate changes
+  // or max_iterations iterations have been made.
   // resizerPreamble() required.
-  void resizeToTargetSlew(Instance *inst);
+  void resizeTimingDriven(int max_iterations);
+  // Estimate the effect of replacing the cell of inst without changing
+  // the network. delay and slew are at the instance output, load_cap is
+  // the output load and required_delta is the change in required time
+  // at the instance inputs (positive is better), less the worst delay
+  // increase of the fanin drivers from the new input pin capacitances.
+  // Return false if inst is not a single output gate, cell is not
+  // equivalent to the instance cell or cell does not have a matching
+  // output port.
+  // resizerPreamble() required.
+  bool estimateReplaceCell(Instance *inst,
+			   LibertyCell *cell,
+			   // Return values.
+			   float &delay,
+			   float &slew,
+			   float &load_cap,
+			   float &required_delta);
+  // Estimate the effect of inserting buffer_cell between drvr_pin and
+  // its loads without changing the network. delay is from the driver
+  // inputs through the buffer, slew is at the buffer output, load_cap is
+  // the driver load and required_delta is the change in required time
+  // at the driver inputs.
+  // Return false if drvr_pin is not a liberty gate output driver.
+  bool estimateInsertBuffer(const Pin *drvr_pin,
+			    LibertyCell *buffer_cell,
+			    // Return values.
+			    float &delay,
+			    float &slew,
+			    float &load_cap,
+			    float &required_delta);
 
   // Insert buffers to fix max cap/slew violations.
   // resizerPreamble() required.
@@ -95,8 +211,43 @@ public:
   // resizerPreamble() required.
   void rebuffer(Net *net,
 		LibertyCell *buffer_cell);
+  // Split the components into shard_count regions with the same number
+  // of components ordered by x location and write dirname/shard<i>.def
+  // for each region. The split only uses the network and placement.
+  // With write_sdc dirname/shard<i>.sdc constrains the shard ports with
+  // the arrivals, required times, slews and loads of the full design,
+  // which requires timing the design.
+  void writeDefShards(const char *dirname,
+		      int shard_count,
+		      bool sort,
+		      bool write_sdc);
+  // Merge the changes made to a shard back into the network.
+  // shard_filename is a shard DEF written by writeDefShards and
+  // resized_filename is the DEF written after it was resized.
+  // Components and nets added to the shard are renamed with prefix.
+  void mergeDefShard(const char *shard_filename,
+		     const char *resized_filename,
+		     const char *prefix);
+  // Write the network, the resizer state and, with parasitics, the
+  // estimated wire parasitics to a binary session file.
+  // Return false if there is no design to write.
+  // Throws FileNotWritable if the file cannot be written.
+  bool writeSession(const char *filename,
+		    bool parasitics);
+  // Read a session written by writeSession. The liberty and LEF files
+  // are read if no LEF library has been read yet.
+  // Return false if the session could not be read.
+  bool readSession(const char *filename);
+  // Write a session to filename every interval seconds while resizing
+  // so an interrupted run can be resumed with readSession.
+  // A null filename disables the checkpoints.
+  void setSessionCheckpoint(const char *filename,
+			    double interval);
   Slew targetSlew(const TransRiseFall *tr);
   float targetLoadCap(LibertyCell *cell);
+  // Relative error of the table batches of cell against the
+  // scalar gate models (for regressions).
+  float tableBatchError(LibertyCell *cell);
   // Area of the design in meter^2.
   double designArea();
 
@@ -105,20 +256,90 @@ protected:
   virtual void makeCmdNetwork();
   void ensureCorner();
   void initCorner(Corner *corner);
-  void ensureClkNets();
-  void findClkNets();
-  bool isClock(Net *net);
+  void ensureClkVertices();
+  void findClkVertices();
+  bool isClock(const Net *net) const;
+  bool isClock(const Vertex *vertex) const;
+  void setClock(const Vertex *vertex);
+  void clearClock(const Instance *inst);
+  void updateBufferClock(Instance *buffer,
+			 const Net *net);
+  bool editNetworkOnly();
+  void editTouchNet(Net *net);
+  void editTouchNets(const Instance *inst);
+  Instance *editMakeInstance(Cell *cell,
+			     const char *name,
+			     Instance *parent);
+  Instance *editMakeInstance(LibertyCell *cell,
+			     const char *name,
+			     Instance *parent);
+  Net *editMakeNet(const char *name,
+		   Instance *parent);
+  void editSetLocation(Instance *inst,
+		       DefPt location);
+  void editConnectPin(Instance *inst,
+		      Port *port,
+		      Net *net);
+  void editConnectPin(Instance *inst,
+		      LibertyPort *port,
+		      Net *net);
+  void editDisconnectPin(Pin *pin);
+  void editReplaceCell(Instance *inst,
+		       Cell *cell);
+  void editDeleteInstance(Instance *inst);
+  void editDeleteNet(Net *net);
   void ensureLevelDrvrVerticies();
+  void updateLevelDrvrVerticies();
+  void recordLevelDrvrLevels();
+  void addLevelDrvrs(const Instance *inst);
+  void removeLevelDrvrs(const Instance *inst);
+  void findFaninDrvrs(const Instance *inst,
+		      // Return value.
+		      VertexSet &drvrs);
+  bool resizeInstance(Instance *inst,
+		      LibertyCell *cell);
+  LibertyCell *findTargetCell(LibertyCell *cell,
+			      float load_cap);
+  bool resizeLevelTiles(const VertexSeq &drvrs,
+			// Return value.
+			VertexSet &requeued);
+  bool useTiles() const;
+  int netTile(const Net *net);
+  int tileIndex(DefPt location) const;
+  void forEachTile(bool parallel,
+		   const std::function<void (int tile)> &func);
+  void makeLrGates(// Return value.
+		   LrGateSeq &gates);
+  void makeLrTableBatches(LrGateSeq &gates);
+  float lrAreaWeight(LrGateSeq &gates);
+  void updateLrGates(LrGateSeq &gates);
+  void updateLrMultipliers(LrGateSeq &gates,
+			   int iteration);
+  void solveLrGates(LrGateSeq &gates,
+		    float area_weight);
+  void solveLrGate(LrGate *gate,
+		   const LrGateSeq &gates,
+		   float area_weight);
+  void makeGateTableBatches(LibertyCell *cell);
+  void deleteLibraryTables();
+  void addLibertyLibrary(LibertyLibrary *library);
+  int bufferPortsEditCount(bool inputs);
   void bufferInput(Pin *top_pin,
 		   LibertyCell *buffer_cell);
   void bufferOutput(Pin *top_pin,
 		    LibertyCell *buffer_cell);
   void makeEquivCells(LibertyLibrarySeq *resize_libs);
   void findTargetLoads(LibertyLibrarySeq *resize_libs);
-  void findTargetLoads(LibertyLibrary *library,
+  void findTargetLoads(const LibertyCellSeq &cells,
+		       Slew slews[]);
+  void findTargetLoads(const LibertyCellSeq &cells,
+		       size_t begin,
+		       size_t end,
+		       Slew slews[],
+		       // Return values.
+		       FloatSeq &target_loads);
+  float findTargetLoad(LibertyCell *cell,
 		       Slew slews[]);
-  void findTargetLoad(LibertyCell *cell,
-		      Slew slews[]);
   float findTargetLoad(LibertyCell *cell,
 		       TimingArc *arc,
 		       Slew in_slew,
@@ -130,8 +351,14 @@ protected:
 			     int counts[]);
   void makeNetParasitics();
   void makeNetParasitics(const Net *net);
-  ParasiticNode *findParasiticNode(SteinerTree *tree,
-				   Parasitic *parasitic,
+  // Return false if the net pins are not placed.
+  bool findNetWireSegments(const Net *net,
+			   // Return value.
+			   ParasiticSegmentSeq &segments);
+  void makeNetParasitics(const Net *net,
+			 const ParasiticSegmentSeq &segments);
+  void parasiticsInvalidDelays(const Net *net);
+  ParasiticNode *findParasiticNode(Parasitic *parasitic,
 				   const Net *net,
 				   const Pin *pin,
 				   int steiner_pt);
@@ -140,8 +367,27 @@ protected:
   void rebuffer(bool repair_max_cap,
 		bool repair_max_slew,
 		LibertyCell *buffer_cell);
-  void rebuffer(const Pin *drvr_pin,
-		LibertyCell *buffer_cell);
+  RebufferNet *makeRebufferNet(const Pin *drvr_pin,
+			       LibertyCell *buffer_cell);
+  void solveRebufferNets(RebufferNetSeq &rnets,
+			 LibertyCell *buffer_cell);
+  void solveRebufferTiles(RebufferNetSeq &rnets,
+			  LibertyCell *buffer_cell);
+  void solveRebufferNet(RebufferNet *rnet,
+			LibertyCell *buffer_cell);
+  void commitRebufferNet(RebufferNet *rnet,
+			 LibertyCell *buffer_cell);
+  void findRebufferRecheck(RebufferNet *rnet,
+			   // Return value.
+			   VertexSet &recheck);
+  void rebufferRecheck(bool repair_max_cap,
+		       bool repair_max_slew,
+		       LibertyCell *buffer_cell,
+		       VertexSet &rebuffered,
+		       VertexSet &recheck);
+  void findFanoutDrvrs(const Pin *drvr_pin,
+		       // Return value.
+		       VertexSet &drvrs);
   bool hasMaxCapViolation(const Pin *drvr_pin);
   bool hasMaxSlewViolation(const Pin *drvr_pin);
   void slewLimit(const Pin *pin,
@@ -150,18 +396,19 @@ protected:
 		 float &limit,
 		 bool &exists) const;
 			
-  RebufferOptionSeq rebufferBottomUp(SteinerTree *tree,
+  RebufferOptionSeq rebufferBottomUp(RebufferNet *rnet,
 				     SteinerPt k,
 				     SteinerPt prev,
 				     int level,
 				     LibertyCell *buffer_cell);
   void rebufferTopDown(RebufferOption *choice,
+		       RebufferNet *rnet,
 		       Net *net,
 		       int level,
 		       LibertyCell *buffer_cell);
   RebufferOptionSeq
   addWireAndBuffer(RebufferOptionSeq Z,
-		   SteinerTree *tree,
+		   RebufferNet *rnet,
 		   SteinerPt k,
 		   SteinerPt prev,
 		   int level,
@@ -174,13 +421,50 @@ protected:
 			  const MinMax *min_max);
   float gateDelay(LibertyPort *out_port,
 		  float load_cap);
+  void gateDelay(LibertyPort *out_port,
+		 const Slew in_slews[],
+		 float load_cap,
+		 // Return values.
+		 float &delay,
+		 float &slew);
+  bool isEquivCell(LibertyCell *inst_cell,
+		   LibertyCell *cell);
+  float faninDelayIncrease(const Instance *inst,
+			   LibertyCell *cell);
+  void findInputSlews(const Instance *inst,
+		      // Return values.
+		      Slew in_slews[]);
+  // Max rise/fall delays for a batch of load caps.
+  void gateDelays(LibertyPort *out_port,
+		  const FloatSeq &load_caps,
+		  // Return values.
+		  FloatSeq &delays);
   float bufferDelay(LibertyCell *buffer_cell,
 		    float load_cap);
+  void findBufferRequireds(RebufferOptionSeq &options,
+			   LibertyCell *buffer_cell);
+  GateTableBatch *gateTableBatch(LibertyCell *cell,
+				 TimingArc *arc);
+  void writeShardSdc(const char *filename,
+		     const DefShard *shard);
+  void ensureNameAllocators();
   string makeUniqueNetName();
   string makeUniqueBufferName();
+  void reserveRebufferNames(RebufferNetSeq &rnets);
+  void makeRebufferNames(RebufferNet *rnet,
+			 // Return values.
+			 string &net_name,
+			 string &buffer_name);
   bool dontUse(LibertyCell *cell);
   bool overMaxArea();
   bool hasTopLevelOutputPort(Net *net);
+  void writeSessionLibraries(SessionWriter &writer);
+  bool readSessionLibraries(SessionReader &reader);
+  void writeSessionState(SessionWriter &writer);
+  void readSessionState(SessionReader &reader);
+  void writeSessionParasitics(SessionWriter &writer);
+  void readSessionParasitics(SessionReader &reader);
+  void writeSessionCheckpoint();
 
   friend class RebufferOption;
   using Sta::makeEquivCells;
@@ -190,6 +474,8 @@ protected:
   Corner *corner_;
   LibertyCellSet dont_use_;
   double max_area_;
+  // Tiles per side of the core area grid.
+  int tile_count_;
   // Die area (meters).
   double die_lx_;
   double die_ly_;
@@ -205,19 +491,48 @@ protected:
   const DcalcAnalysisPt *dcalc_ap_;
   const Pvt *pvt_;
   const ParasiticAnalysisPt *parasitics_ap_;
-  NetSet clk_nets_;
-  bool clk_nets__valid_;
+  // Vertices on clock nets indexed by graph vertex id.
+  Vector<bool> clk_vertices_;
+  bool clk_vertices_valid_;
   CellTargetLoadMap *target_load_map_;
+  // Libraries target_load_map_ and tgt_slews_ were found for.
+  LibertyLibrarySeq target_load_libs_;
+  // Batched table lookups for the analysis pt pvt.
+  GateTableBatchMap gate_table_batches_;
+  // Driver vertices sorted by level.
   VertexSeq level_drvr_verticies_;
+  // Level of each driver when level_drvr_verticies_ was last sorted.
+  Vector<Level> level_drvr_levels_;
+  // Drivers made or deleted since level_drvr_verticies_ was updated.
+  VertexSeq level_drvr_pending_;
+  VertexSet level_drvr_removed_;
   bool level_drvr_verticies_valid_;
+  // Nesting depth of edit batches.
+  int edit_batch_depth_;
+  // The graph is out of date until the edit batch is committed.
+  bool edit_batch_network_only_;
+  // Nets whose parasitics are estimated when the edit batch is committed.
+  NetSet edit_batch_nets_;
+  // Edits since checkpointEdits, or nullptr when not recording.
+  EditJournal *edit_journal_;
   Slew tgt_slews_[TransRiseFall::index_count];
-  int unique_net_index_;
-  int unique_buffer_index_;
+  NameAllocator net_names_;
+  NameAllocator buffer_names_;
+  // Existing names have been noted by the allocators.
+  bool names_valid_;
+  // LefDefNetwork::designEpoch when the names were noted.
+  int names_design_epoch_;
   int resize_count_;
   int inserted_buffer_count_;
   int rebuffer_net_count_;
+  // Drivers of the buffers inserted by rebufferTopDown.
+  VertexSeq rebuffer_drvrs_;
   double core_area_;
   double design_area_;
+  // Periodic session checkpoints while resizing.
+  string session_checkpoint_filename_;
+  double session_checkpoint_interval_;
+  std::chrono::steady_clock::time_point session_checkpoint_time_;
 };
 
 } // namespace
@@ -24,6 +24,7 @@
 #include "ResizerConfig.hh"  // RESIZER_VERSION
 #include "Error.hh"
 #include "Liberty.hh"
+#include "StringSeq.hh"
 #include "LefReader.hh"
 #include "DefReader.hh"
 #include "DefWriter.hh"
@@ -100,6 +101,56 @@ using namespace sta;
   $1 = tclListSeqLibertyCell($input, interp);
 }
 
+%typemap(in) StringSeq* {
+  int argc;
+  Tcl_Obj **argv;
+  if (Tcl_ListObjGetElements(interp, $input, &argc, &argv) == TCL_OK) {
+    StringSeq *seq = new StringSeq;
+    for (int i = 0; i < argc; i++) {
+      int length;
+      const char *str = Tcl_GetStringFromObj(argv[i], &length);
+      seq->push_back(str);
+    }
+    $1 = seq;
+  }
+  else
+    return TCL_ERROR;
+}
+
+%typemap(freearg) StringSeq* {
+  delete $1;
+}
+
+%typemap(out) InstanceSeq {
+  InstanceSeq &insts = $1;
+  Tcl_Obj *list = Tcl_NewListObj(0, nullptr);
+  for (Instance *inst : insts) {
+    Tcl_Obj *obj = SWIG_NewInstanceObj(inst, $descriptor(Instance*), false);
+    Tcl_ListObjAppendElement(interp, list, obj);
+  }
+  Tcl_SetObjResult(interp, list);
+}
+
+%typemap(out) PortSeq {
+  PortSeq &ports = $1;
+  Tcl_Obj *list = Tcl_NewListObj(0, nullptr);
+  for (Port *port : ports) {
+    Tcl_Obj *obj = SWIG_NewInstanceObj(port, $descriptor(Port*), false);
+    Tcl_ListObjAppendElement(interp, list, obj);
+  }
+  Tcl_SetObjResult(interp, list);
+}
+
+%typemap(out) FloatSeq {
+  FloatSeq &values = $1;
+  Tcl_Obj *list = Tcl_NewListObj(0, nullptr);
+  for (float value : values) {
+    Tcl_Obj *obj = Tcl_NewDoubleObj(value);
+    Tcl_ListObjAppendElement(interp, list, obj);
+  }
+  Tcl_SetObjResult(interp, list);
+}
+
 ////////////////////////////////////////////////////////////////
 //
 // C++ functions visible as TCL functions.
@@ -124,7 +175,7 @@ void
 read_lef(const char *filename)
 {
   LefDefNetwork *network = lefDefNetwork();
-  readLef(filename, network);
+  readLef(filename, true, network);
 }
 
 bool
@@ -135,10 +186,31 @@ lef_exists()
 }
 
 void
-read_def(const char *filename)
+read_def_cmd(const char *filename,
+	     bool skip_routing,
+	     bool skip_special_nets,
+	     bool skip_fills,
+	     bool skip_blockages,
+	     bool fast)
 {
   Resizer *resizer = getResizer();
-  resizer->readDef(filename);
+  DefSkip skip;
+  skip.routing_ = skip_routing;
+  skip.special_nets_ = skip_special_nets;
+  skip.fills_ = skip_fills;
+  skip.blockages_ = skip_blockages;
+  resizer->readDef(filename, skip, fast);
+}
+
+void
+read_design_files_cmd(StringSeq *liberty_files,
+		      const char *lef_filename,
+		      const char *def_filename)
+{
+  Resizer *resizer = getResizer();
+  resizer->readDesignFiles(liberty_files,
+			   lef_filename[0] ? lef_filename : nullptr,
+			   def_filename[0] ? def_filename : nullptr);
 }
 
 void
@@ -190,7 +262,8 @@ write_def_cmd(const char *filename,
 	      const char *site_name,
 	      const char *tracks_file,
 	      bool auto_place_pins,
-	      bool sort)
+	      bool sort,
+	      int compress_level)
 {
   LefDefNetwork *network = lefDefNetwork();
   Resizer *resizer = getResizer();
@@ -205,7 +278,27 @@ write_def_cmd(const char *filename,
   writeDef(filename, units,
 	   die_lx, die_ly, die_ux, die_uy,
 	   core_lx, core_ly, core_ux, core_uy,
-	   site_name, tracks_file, auto_place_pins, sort, network);
+	   site_name, tracks_file, auto_place_pins, sort,
+	   compress_level, resizer->threadCount(), network);
+}
+
+void
+write_def_shards_cmd(const char *dirname,
+		     int shard_count,
+		     bool sort,
+		     bool write_sdc)
+{
+  Resizer *resizer = getResizer();
+  resizer->writeDefShards(dirname, shard_count, sort, write_sdc);
+}
+
+void
+merge_def_shard_cmd(const char *shard_filename,
+		    const char *resized_filename,
+		    const char *prefix)
+{
+  Resizer *resizer = getResizer();
+  resizer->mergeDefShard(shard_filename, resized_filename, prefix);
 }
 
 void
@@ -224,6 +317,72 @@ set_max_utilization(double max_utilization)
   resizer->setMaxUtilization(max_utilization);
 }
 
+void
+set_tile_count(int tile_count)
+{
+  Resizer *resizer = getResizer();
+  resizer->setTileCount(tile_count);
+}
+
+void
+set_name_prefixes(const char *buffer_prefix,
+		  const char *net_prefix)
+{
+  Resizer *resizer = getResizer();
+  resizer->setNamePrefixes(buffer_prefix, net_prefix);
+}
+
+void
+checkpoint_edits_cmd()
+{
+  Resizer *resizer = getResizer();
+  resizer->checkpointEdits();
+}
+
+void
+rollback_edits_cmd()
+{
+  Resizer *resizer = getResizer();
+  resizer->rollbackEdits();
+}
+
+void
+accept_edits_cmd()
+{
+  Resizer *resizer = getResizer();
+  resizer->acceptEdits();
+}
+
+bool
+have_edit_checkpoint()
+{
+  Resizer *resizer = getResizer();
+  return resizer->haveEditCheckpoint();
+}
+
+void
+write_session_cmd(const char *filename,
+		  bool parasitics)
+{
+  Resizer *resizer = getResizer();
+  resizer->writeSession(filename, parasitics);
+}
+
+bool
+read_session_cmd(const char *filename)
+{
+  Resizer *resizer = getResizer();
+  return resizer->readSession(filename);
+}
+
+void
+set_session_checkpoint(const char *filename,
+		       double interval)
+{
+  Resizer *resizer = getResizer();
+  resizer->setSessionCheckpoint(filename[0] ? filename : nullptr, interval);
+}
+
 void
 set_dont_use(LibertyCellSeq *dont_use)
 {
@@ -253,10 +412,53 @@ buffer_outputs(LibertyCell *buffer_cell)
 }
 
 void
-resize_to_target_slew()
+resize_to_target_slew(int max_iterations)
 {
   Resizer *resizer = getResizer();
-  resizer->resizeToTargetSlew();
+  resizer->resizeToTargetSlew(max_iterations);
+}
+
+void
+resize_timing_driven(int max_iterations)
+{
+  Resizer *resizer = getResizer();
+  resizer->resizeTimingDriven(max_iterations);
+}
+
+// Return {delay slew load_cap required_delta} or {}.
+FloatSeq
+estimate_replace_cell_cmd(Instance *inst,
+			  LibertyCell *cell)
+{
+  Resizer *resizer = getResizer();
+  float delay, slew, load_cap, required_delta;
+  FloatSeq values;
+  if (resizer->estimateReplaceCell(inst, cell, delay, slew,
+				   load_cap, required_delta)) {
+    values.push_back(delay);
+    values.push_back(slew);
+    values.push_back(load_cap);
+    values.push_back(required_delta);
+  }
+  return values;
+}
+
+// Return {delay slew load_cap required_delta} or {}.
+FloatSeq
+estimate_insert_buffer_cmd(Pin *drvr_pin,
+			   LibertyCell *buffer_cell)
+{
+  Resizer *resizer = getResizer();
+  float delay, slew, load_cap, required_delta;
+  FloatSeq values;
+  if (resizer->estimateInsertBuffer(drvr_pin, buffer_cell, delay, slew,
+				    load_cap, required_delta)) {
+    values.push_back(delay);
+    values.push_back(slew);
+    values.push_back(load_cap);
+    values.push_back(required_delta);
+  }
+  return values;
 }
 
 void
@@ -297,6 +499,13 @@ resize_target_load_cap(LibertyCell *cell)
   return resizer->targetLoadCap(cell);
 }
 
+float
+table_batch_error(LibertyCell *cell)
+{
+  Resizer *resizer = getResizer();
+  return resizer->tableBatchError(cell);
+}
+
 float
 design_area()
 {
@@ -304,4 +513,72 @@ design_area()
   return resizer->designArea();
 }
 
+InstanceSeq
+find_instances_in_window_cmd(// Window (meters).
+			     double lx,
+			     double ly,
+			     double ux,
+			     double uy)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  InstanceSeq insts;
+  network->findInstancesInWindow(DefPt(network->metersToDbu(lx),
+				       network->metersToDbu(ly)),
+				 DefPt(network->metersToDbu(ux),
+				       network->metersToDbu(uy)),
+				 insts);
+  return insts;
+}
+
+InstanceSeq
+find_nearest_instances_cmd(// Location (meters).
+			   double x,
+			   double y,
+			   int count)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  InstanceSeq insts;
+  network->findNearestInstances(DefPt(network->metersToDbu(x),
+				      network->metersToDbu(y)),
+				count, insts);
+  return insts;
+}
+
+PortSeq
+find_ports_in_window_cmd(// Window (meters).
+			 double lx,
+			 double ly,
+			 double ux,
+			 double uy)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  PinSeq pins;
+  network->findPortsInWindow(DefPt(network->metersToDbu(lx),
+				   network->metersToDbu(ly)),
+			     DefPt(network->metersToDbu(ux),
+				   network->metersToDbu(uy)),
+			     pins);
+  PortSeq ports;
+  for (auto pin : pins)
+    ports.push_back(network->port(pin));
+  return ports;
+}
+
+PortSeq
+find_nearest_ports_cmd(// Location (meters).
+		       double x,
+		       double y,
+		       int count)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  PinSeq pins;
+  network->findNearestPorts(DefPt(network->metersToDbu(x),
+				  network->metersToDbu(y)),
+			    count, pins);
+  PortSeq ports;
+  for (auto pin : pins)
+    ports.push_back(network->port(pin));
+  return ports;
+}
+
 %} // inline
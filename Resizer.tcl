@@ -31,7 +31,62 @@ define_cmd_args "set_dont_use" {cell dont_use}
 # Defined by SWIG interface Resizer.i
 define_cmd_args "read_lef" {filename}
 
-define_cmd_args "read_def" {filename}
+define_cmd_args "read_def" {[-skip sections] [-fast] filename}
+
+# -skip is a list (or comma separated) of routing, specialnets, fills
+# and blockages.
+proc read_def { args } {
+  parse_key_args "read_def" args keys {-skip} flags {-fast}
+  check_argc_eq1 "read_def" $args
+  set filename [file nativename [lindex $args 0]]
+
+  set skip_routing 0
+  set skip_special_nets 0
+  set skip_fills 0
+  set skip_blockages 0
+  if [info exists keys(-skip)] {
+    foreach section [split $keys(-skip) ", "] {
+      if { $section == "routing" } {
+	set skip_routing 1
+      } elseif { $section == "specialnets" } {
+	set skip_special_nets 1
+      } elseif { $section == "fills" } {
+	set skip_fills 1
+      } elseif { $section == "blockages" } {
+	set skip_blockages 1
+      } elseif { $section != "" } {
+	sta_error "-skip $section is not routing, specialnets, fills or blockages."
+      }
+    }
+  }
+  set fast [info exists flags(-fast)]
+  read_def_cmd $filename $skip_routing $skip_special_nets \
+    $skip_fills $skip_blockages $fast
+}
+
+define_cmd_args "read_design_files" {[-liberty liberty_files]\
+				       [-lef lef_file] [-def def_file]}
+
+proc read_design_files { args } {
+  parse_key_args "read_design_files" args keys {-liberty -lef -def} flags {}
+  check_argc_eq0 "read_design_files" $args
+
+  set liberty_files {}
+  if [info exists keys(-liberty)] {
+    foreach liberty_file $keys(-liberty) {
+      lappend liberty_files [file nativename $liberty_file]
+    }
+  }
+  set lef_file ""
+  if [info exists keys(-lef)] {
+    set lef_file [file nativename $keys(-lef)]
+  }
+  set def_file ""
+  if [info exists keys(-def)] {
+    set def_file [file nativename $keys(-def)]
+  }
+  read_design_files_cmd $liberty_files $lef_file $def_file
+}
 
 define_cmd_args "set_design_size" {[-die {lx ly ux uy}]\
 				     [-core {lx ly ux uy}]}
@@ -81,11 +136,12 @@ define_cmd_args "write_def" {-units def_units\
 			       [-tracks tracks_file]\
 			       [-auto_place_pins]\
 			       [-sort]\
+			       [-compress_level level]\
 			       filename}
 
 proc write_def { args } {
   parse_key_args "write_def" args \
-    keys {-units -die_area -core_area -site -tracks} \
+    keys {-units -die_area -core_area -site -tracks -compress_level} \
     flags {-auto_place_pins -sort}
 
   set units 1000
@@ -140,12 +196,143 @@ proc write_def { args } {
 
   set sort [info exists flags(-sort)]
 
+  # Only used for file names ending in .gz.
+  set compress_level 6
+  if { [info exists keys(-compress_level)] } {
+    set compress_level $keys(-compress_level)
+    check_positive_integer "-compress_level" $compress_level
+    if { $compress_level > 9 } {
+      sta_error "-compress_level must be between 1 and 9."
+    }
+  }
+
   check_argc_eq1 "write_def" $args
   set filename $args
 
   # convert die coordinates to meters.
   write_def_cmd $filename $units \
-    $site_name $tracks_file $auto_place_pins $sort
+    $site_name $tracks_file $auto_place_pins $sort $compress_level
+}
+
+define_cmd_args "write_def_shards" {[-shards count] [-sort] [-sdc] dirname}
+
+proc write_def_shards { args } {
+  parse_key_args "write_def_shards" args keys {-shards} flags {-sort -sdc}
+
+  set shards 2
+  if [info exists keys(-shards)] {
+    set shards $keys(-shards)
+    check_positive_integer "-shards" $shards
+  }
+  set sort [info exists flags(-sort)]
+  set write_sdc [info exists flags(-sdc)]
+  check_argc_eq1 "write_def_shards" $args
+  set dirname [file nativename [lindex $args 0]]
+  file mkdir $dirname
+  write_def_shards_cmd $dirname $shards $sort $write_sdc
+}
+
+# Shard file roots in dirname (dirname/shard<i>) in shard order.
+proc def_shard_roots { dirname } {
+  set roots {}
+  foreach def_file [glob -nocomplain -directory $dirname shard*.def] {
+    set root [file rootname $def_file]
+    # Skip the resized shards.
+    if { [regexp {^shard[0-9]+$} [file tail $root]] } {
+      lappend roots $root
+    }
+  }
+  return [lsort -dictionary $roots]
+}
+
+define_cmd_args "run_def_shards" {-liberty liberty_files -lef lef_file\
+				    -script script_file [-jobs count]\
+				    [-launcher command] dirname}
+
+# Resize each shard written by write_def_shards in a separate resizer
+# process. The script is sourced after the shard DEF and SDC are read.
+# The launcher command prefix can submit the processes to a batch
+# system; it must wait for the process to finish.
+proc run_def_shards { args } {
+  parse_key_args "run_def_shards" args \
+    keys {-liberty -lef -script -jobs -launcher} flags {}
+
+  foreach key {-liberty -lef -script} {
+    if { ![info exists keys($key)] } {
+      sta_error "Error: run_def_shards $key required."
+    }
+  }
+  set jobs 0
+  if [info exists keys(-jobs)] {
+    set jobs $keys(-jobs)
+    check_positive_integer "-jobs" $jobs
+  }
+  set launcher {}
+  if [info exists keys(-launcher)] {
+    set launcher $keys(-launcher)
+  }
+  check_argc_eq1 "run_def_shards" $args
+  set dirname [lindex $args 0]
+  set roots [def_shard_roots $dirname]
+  if { $roots == {} } {
+    sta_error "Error: no shards found in $dirname."
+  }
+  # Run all of the shards at once by default.
+  if { $jobs == 0 } {
+    set jobs [llength $roots]
+  }
+
+  foreach root $roots {
+    set stream [open $root.tcl w]
+    foreach liberty_file $keys(-liberty) {
+      puts $stream [list read_liberty [file normalize $liberty_file]]
+    }
+    puts $stream [list read_lef [file normalize $keys(-lef)]]
+    puts $stream [list read_def [file normalize $root.def]]
+    if { [file exists $root.sdc] } {
+      puts $stream [list read_sdc [file normalize $root.sdc]]
+    }
+    puts $stream [list source [file normalize $keys(-script)]]
+    puts $stream [list write_def [file normalize ${root}_resized.def]]
+    close $stream
+  }
+
+  set resizer [info nameofexecutable]
+  set failed 0
+  for {set i 0} {$i < [llength $roots]} {incr i $jobs} {
+    set channels {}
+    foreach root [lrange $roots $i [expr $i + $jobs - 1]] {
+      set cmd [concat $launcher [list $resizer -exit $root.tcl]]
+      lappend channels $root [open "|$cmd 2>@1" r]
+    }
+    foreach {root channel} $channels {
+      set log [open $root.log w]
+      puts -nonewline $log [read $channel]
+      close $log
+      if { [catch {close $channel}] } {
+	sta_warn "Warning: [file tail $root] failed. See $root.log."
+	incr failed
+      }
+    }
+  }
+  if { $failed } {
+    sta_error "Error: $failed shards failed."
+  }
+}
+
+define_cmd_args "merge_def_shards" {dirname}
+
+proc merge_def_shards { args } {
+  check_argc_eq1 "merge_def_shards" $args
+  set dirname [lindex $args 0]
+  foreach root [def_shard_roots $dirname] {
+    set resized_file ${root}_resized.def
+    if { [file exists $resized_file] } {
+      merge_def_shard_cmd $root.def $resized_file "[file tail $root]_"
+    } else {
+      sta_warn "Warning: $resized_file not found."
+    }
+  }
 }
 
 define_cmd_args "set_wire_rc" {[-resistance res ][-capacitance cap]\
@@ -175,24 +362,35 @@ proc set_wire_rc { args } {
 define_cmd_args "resize" {[-buffer_inputs]\
 			    [-buffer_outputs]\
 			    [-resize]\
+			    [-timing_driven]\
+			    [-max_resize_iterations count]\
+			    [-tiles count]\
+			    [-buffer_name_prefix prefix]\
+			    [-net_name_prefix prefix]\
 			    [-repair_max_cap]\
 			    [-repair_max_slew]\
 			    [-resize_libraries resize_libs]\
 			    [-buffer_cell buffer_cell]\
-			    [-dont_use lib_cells]}
+			    [-dont_use lib_cells]\
+			    [-checkpoint filename]\
+			    [-checkpoint_interval seconds]}
 
 proc resize { args } {
   parse_key_args "resize" args \
-    keys {-buffer_cell -resize_libraries -dont_use -max_utilization} \
-    flags {-buffer_inputs -buffer_outputs -resize -repair_max_cap -repair_max_slew}
+    keys {-buffer_cell -resize_libraries -dont_use -max_utilization \
+	    -max_resize_iterations -tiles -buffer_name_prefix \
+	    -net_name_prefix -checkpoint -checkpoint_interval} \
+    flags {-buffer_inputs -buffer_outputs -resize -repair_max_cap -repair_max_slew \
+	     -timing_driven}
 
   set buffer_inputs [info exists flags(-buffer_inputs)]
   set buffer_outputs [info exists flags(-buffer_outputs)]
   set resize [info exists flags(-resize)]
+  set timing_driven [info exists flags(-timing_driven)]
   set repair_max_cap [info exists flags(-repair_max_cap)]
   set repair_max_slew [info exists flags(-repair_max_slew)]
   # With no options you get the whole salmai.
-  if { !($buffer_inputs || $buffer_outputs || $resize \
+  if { !($buffer_inputs || $buffer_outputs || $resize || $timing_driven \
 	   || $repair_max_cap || $repair_max_slew) } {
     set buffer_inputs 1
     set buffer_outputs 1
@@ -238,11 +436,50 @@ proc resize { args } {
     set max_util [expr $max_util / 100.0]
   }
 
+  if { $timing_driven } {
+    set resize 1
+    set max_resize_iterations 10
+  } else {
+    set max_resize_iterations 1
+  }
+  if { [info exists keys(-max_resize_iterations)] } {
+    set max_resize_iterations $keys(-max_resize_iterations)
+    check_positive_integer "-max_resize_iterations" $max_resize_iterations
+  }
+
+  set tiles 0
+  if { [info exists keys(-tiles)] } {
+    set tiles $keys(-tiles)
+    check_positive_integer "-tiles" $tiles
+  }
+
+  set buffer_name_prefix "buffer"
+  if { [info exists keys(-buffer_name_prefix)] } {
+    set buffer_name_prefix $keys(-buffer_name_prefix)
+  }
+  set net_name_prefix "net"
+  if { [info exists keys(-net_name_prefix)] } {
+    set net_name_prefix $keys(-net_name_prefix)
+  }
+
+  set checkpoint ""
+  if { [info exists keys(-checkpoint)] } {
+    set checkpoint [file nativename $keys(-checkpoint)]
+  }
+  set checkpoint_interval 600
+  if { [info exists keys(-checkpoint_interval)] } {
+    set checkpoint_interval $keys(-checkpoint_interval)
+    check_positive_float "-checkpoint_interval" $checkpoint_interval
+  }
+
   check_argc_eq0 "resize" $args
 
+  set_session_checkpoint $checkpoint $checkpoint_interval
   resizer_preamble $resize_libs
   set_dont_use $dont_use
   set_max_utilization $max_util
+  set_tile_count $tiles
+  set_name_prefixes $buffer_name_prefix $net_name_prefix
   if { $buffer_inputs } {
     buffer_inputs $buffer_cell
   }
@@ -250,11 +487,55 @@ proc resize { args } {
     buffer_outputs $buffer_cell
   }
   if { $resize } {
-    resize_to_target_slew
+    if { $timing_driven } {
+      resize_timing_driven $max_resize_iterations
+    } else {
+      resize_to_target_slew $max_resize_iterations
+    }
   }
   if { $repair_max_cap || $repair_max_slew } {
     rebuffer_nets $repair_max_cap $repair_max_slew $buffer_cell
   }
+  set_session_checkpoint "" 0
+}
+
+define_cmd_args "write_session" {[-parasitics] filename}
+
+proc write_session { args } {
+  parse_key_args "write_session" args keys {} flags {-parasitics}
+  check_argc_eq1 "write_session" $args
+  set parasitics [info exists flags(-parasitics)]
+  write_session_cmd [file nativename [lindex $args 0]] $parasitics
+}
+
+define_cmd_args "read_session" {filename}
+
+proc read_session { args } {
+  check_argc_eq1 "read_session" $args
+  if { ![read_session_cmd [file nativename [lindex $args 0]]] } {
+    sta_error "Error: read_session failed."
+  }
+}
+
+define_cmd_args "checkpoint_edits" {}
+
+proc checkpoint_edits {} {
+  checkpoint_edits_cmd
+}
+
+define_cmd_args "rollback_edits" {}
+
+proc rollback_edits {} {
+  if { ![have_edit_checkpoint] } {
+    sta_error "Error: no edit checkpoint to roll back to."
+  }
+  rollback_edits_cmd
+}
+
+define_cmd_args "accept_edits" {}
+
+proc accept_edits {} {
+  accept_edits_cmd
 }
 
 define_cmd_args "get_pin_net" {pin_name}
@@ -264,6 +545,96 @@ proc get_pin_net { pin_name } {
   return [$pin net]
 }
 
+define_cmd_args "estimate_replace_cell" {instance lib_cell}
+
+# Return {delay slew load_cap required_delta} in user units.
+proc estimate_replace_cell { inst_name lib_cell_name } {
+  set inst [get_instance_error "instance" $inst_name]
+  set lib_cell [get_lib_cell_error "lib_cell" $lib_cell_name]
+  return [estimate_ui [estimate_replace_cell_cmd $inst $lib_cell]]
+}
+
+define_cmd_args "estimate_insert_buffer" {drvr_pin buffer_cell}
+
+# Return {delay slew load_cap required_delta} in user units.
+proc estimate_insert_buffer { pin_name buffer_cell_name } {
+  set pin [get_pin_error "drvr_pin" $pin_name]
+  set buffer_cell [get_lib_cell_error "buffer_cell" $buffer_cell_name]
+  if { ![get_property $buffer_cell is_buffer] } {
+    sta_error "Error: [get_name $buffer_cell] is not a buffer."
+  }
+  return [estimate_ui [estimate_insert_buffer_cmd $pin $buffer_cell]]
+}
+
+proc estimate_ui { estimate } {
+  if { $estimate == {} } {
+    return {}
+  }
+  lassign $estimate delay slew load_cap required_delta
+  return [list [time_sta_ui $delay] [time_sta_ui $slew] \
+	    [capacitance_sta_ui $load_cap] [time_sta_ui $required_delta]]
+}
+
+define_cmd_args "find_instances_in_window" {lx ly ux uy}
+
+# Placed instances with locations inside the window.
+proc find_instances_in_window { lx ly ux uy } {
+  foreach coord [list $lx $ly $ux $uy] {
+    check_float "window" $coord
+  }
+  return [find_instances_in_window_cmd \
+	    [distance_ui_sta $lx] [distance_ui_sta $ly] \
+	    [distance_ui_sta $ux] [distance_ui_sta $uy]]
+}
+
+define_cmd_args "find_nearest_instances" {[-count count] x y}
+
+# Placed instances nearest to x y, nearest first.
+proc find_nearest_instances { args } {
+  parse_key_args "find_nearest_instances" args keys {-count} flags {}
+  check_argc_eq2 "find_nearest_instances" $args
+  lassign $args x y
+  check_float "x" $x
+  check_float "y" $y
+  set count 1
+  if [info exists keys(-count)] {
+    set count $keys(-count)
+    check_positive_integer "-count" $count
+  }
+  return [find_nearest_instances_cmd \
+	    [distance_ui_sta $x] [distance_ui_sta $y] $count]
+}
+
+define_cmd_args "find_ports_in_window" {lx ly ux uy}
+
+# Top level ports with locations inside the window.
+proc find_ports_in_window { lx ly ux uy } {
+  foreach coord [list $lx $ly $ux $uy] {
+    check_float "window" $coord
+  }
+  return [find_ports_in_window_cmd \
+	    [distance_ui_sta $lx] [distance_ui_sta $ly] \
+	    [distance_ui_sta $ux] [distance_ui_sta $uy]]
+}
+
+define_cmd_args "find_nearest_ports" {[-count count] x y}
+
+# Top level ports nearest to x y, nearest first.
+proc find_nearest_ports { args } {
+  parse_key_args "find_nearest_ports" args keys {-count} flags {}
+  check_argc_eq2 "find_nearest_ports" $args
+  lassign $args x y
+  check_float "x" $x
+  check_float "y" $y
+  set count 1
+  if [info exists keys(-count)] {
+    set count $keys(-count)
+    check_positive_integer "-count" $count
+  }
+  return [find_nearest_ports_cmd \
+	    [distance_ui_sta $x] [distance_ui_sta $y] $count]
+}
+
 define_cmd_args "report_design_area" {}
 
 proc report_design_area {} {
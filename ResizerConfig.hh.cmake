@@ -3,3 +3,7 @@
 #define RESIZER_GIT_SHA1 "${RESIZER_GIT_SHA1}"
 				      
 #define ZLIB ${ZLIB}
+
+#define FOPENCOOKIE ${FOPENCOOKIE}
+
+#define FUNOPEN ${FUNOPEN}
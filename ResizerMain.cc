@@ -28,6 +28,7 @@ using sta::stringEq;
 using sta::Resizer;
 using sta::findCmdLineFlag;
 using sta::findCmdLineKey;
+using sta::parseThreadsArg;
 using sta::evalTclInit;
 using sta::sourceTclFile;
 
@@ -69,6 +70,8 @@ main(int argc,
     Sta::setSta(resizer);
     resizer->makeComponents();
     resizer->initFlute(argv[0]);
+    int thread_count = parseThreadsArg(argc, argv);
+    resizer->setThreadCount(thread_count);
 
     resizer_argc = argc;
     resizer_argv = argv;
@@ -82,11 +85,12 @@ main(int argc,
 static void
 showUseage(char *prog)
 {
-  printf("Usage: %s [-help] [-version] [-no_init] [-no_splash] cmd_file\n", prog);
+  printf("Usage: %s [-help] [-version] [-no_init] [-no_splash] [-threads count|max] cmd_file\n", prog);
   printf("  -help              show help and exit\n");
   printf("  -version           show version and exit\n");
   printf("  -no_init           do not read .sta init file\n");
   printf("  -no_splash         do not show the license splash at startup\n");
+  printf("  -threads count|max use count threads\n");
   printf("  cmd_file           source cmd_file and exit\n");
 }
 
@@ -0,0 +1,570 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstring>
+#include <algorithm>
+#include "Machine.hh"
+#include "Error.hh"
+#include "PortDirection.hh"
+#include "Liberty.hh"
+#include "LefDefNetwork.hh"
+#include "Session.hh"
+
+namespace sta {
+
+const char session_magic[8] = {'R', 'S', 'Z', 'S', 'E', 'S', 'S', '\0'};
+
+SessionWriter::SessionWriter(const char *filename) :
+  filename_(filename),
+  stream_(fopen(filename, "wb"))
+{
+  if (stream_ == nullptr)
+    throw FileNotWritable(filename);
+}
+
+SessionWriter::~SessionWriter()
+{
+  if (stream_)
+    fclose(stream_);
+}
+
+void
+SessionWriter::close()
+{
+  bool error = ferror(stream_) != 0;
+  error |= fclose(stream_) != 0;
+  stream_ = nullptr;
+  if (error)
+    throw FileNotWritable(filename_.c_str());
+}
+
+void
+SessionWriter::write(const void *data,
+		     size_t size)
+{
+  if (fwrite(data, 1, size, stream_) != size)
+    throw FileNotWritable(filename_.c_str());
+}
+
+void
+SessionWriter::writeInt(int32_t value)
+{
+  write(&value, sizeof(value));
+}
+
+void
+SessionWriter::writeUInt(uint32_t value)
+{
+  write(&value, sizeof(value));
+}
+
+void
+SessionWriter::writeFloat(float value)
+{
+  write(&value, sizeof(value));
+}
+
+void
+SessionWriter::writeDouble(double value)
+{
+  write(&value, sizeof(value));
+}
+
+void
+SessionWriter::writeBool(bool value)
+{
+  uint8_t byte = value;
+  write(&byte, sizeof(byte));
+}
+
+void
+SessionWriter::writeString(const char *str)
+{
+  uint32_t length = str ? strlen(str) : 0;
+  writeUInt(length);
+  if (length > 0)
+    write(str, length);
+}
+
+void
+SessionWriter::writeString(const string &str)
+{
+  writeString(str.c_str());
+}
+
+void
+SessionWriter::writeHeader()
+{
+  write(session_magic, sizeof(session_magic));
+  writeUInt(session_byte_order);
+  writeUInt(session_version);
+}
+
+////////////////////////////////////////////////////////////////
+
+SessionReader::SessionReader(const char *filename) :
+  file_(filename),
+  offset_(0),
+  error_(false),
+  swap_(false)
+{
+}
+
+bool
+SessionReader::read(void *data,
+		    size_t size)
+{
+  if (error_ || size > file_.size() - offset_) {
+    error_ = true;
+    memset(data, 0, size);
+    return false;
+  }
+  memcpy(data, file_.data() + offset_, size);
+  offset_ += size;
+  return true;
+}
+
+void
+SessionReader::readValue(void *data,
+			 size_t size)
+{
+  if (read(data, size) && swap_) {
+    char *bytes = static_cast<char*>(data);
+    std::reverse(bytes, bytes + size);
+  }
+}
+
+int32_t
+SessionReader::readInt()
+{
+  int32_t value;
+  readValue(&value, sizeof(value));
+  return value;
+}
+
+uint32_t
+SessionReader::readUInt()
+{
+  uint32_t value;
+  readValue(&value, sizeof(value));
+  return value;
+}
+
+float
+SessionReader::readFloat()
+{
+  float value;
+  readValue(&value, sizeof(value));
+  return value;
+}
+
+double
+SessionReader::readDouble()
+{
+  double value;
+  readValue(&value, sizeof(value));
+  return value;
+}
+
+bool
+SessionReader::readBool()
+{
+  uint8_t byte;
+  read(&byte, sizeof(byte));
+  return byte != 0;
+}
+
+string
+SessionReader::readString()
+{
+  uint32_t length = readUInt();
+  if (error_ || length > file_.size() - offset_) {
+    error_ = true;
+    return string();
+  }
+  string str(file_.data() + offset_, length);
+  offset_ += length;
+  return str;
+}
+
+bool
+SessionReader::readHeader()
+{
+  char magic[sizeof(session_magic)];
+  read(magic, sizeof(magic));
+  uint32_t byte_order = readUInt();
+  if (byte_order != session_byte_order) {
+    // Written on a machine with the other byte order.
+    swap_ = true;
+    char *bytes = reinterpret_cast<char*>(&byte_order);
+    std::reverse(bytes, bytes + sizeof(byte_order));
+  }
+  uint32_t version = readUInt();
+  return !error_
+    && memcmp(magic, session_magic, sizeof(magic)) == 0
+    && byte_order == session_byte_order
+    && version == session_version;
+}
+
+
+////////////////////////////////////////////////////////////////
+
+static void
+writeSessionPorts(SessionWriter &writer,
+		  LefDefNetwork *network);
+static void
+writeSessionInstances(SessionWriter &writer,
+		      LefDefNetwork *network,
+		      // Return value.
+		      UnorderedMap<const Instance*, int> &inst_index);
+static void
+writeSessionComponentExtra(SessionWriter &writer,
+			   const DefComponentExtra *extra);
+static void
+writeSessionNets(SessionWriter &writer,
+		 LefDefNetwork *network,
+		 const UnorderedMap<const Instance*, int> &inst_index);
+static void
+readSessionPorts(SessionReader &reader,
+		 LefDefNetwork *network);
+static void
+readSessionInstances(SessionReader &reader,
+		     LefDefNetwork *network,
+		     // Return value.
+		     InstanceSeq &insts);
+static void
+readSessionComponentExtra(SessionReader &reader,
+			  // Return value.
+			  DefComponentExtra &extra);
+static void
+readSessionNets(SessionReader &reader,
+		LefDefNetwork *network,
+		const InstanceSeq &insts);
+
+void
+writeSessionNetwork(SessionWriter &writer,
+		    LefDefNetwork *network)
+{
+  writer.writeString(network->defFilename());
+  writer.writeInt(network->defUnits());
+  DefDbu die_lx, die_ly, die_ux, die_uy;
+  network->dieArea(die_lx, die_ly, die_ux, die_uy);
+  writer.writeInt(die_lx);
+  writer.writeInt(die_ly);
+  writer.writeInt(die_ux);
+  writer.writeInt(die_uy);
+  writer.writeInt(network->pathDivider());
+  ConcreteLibrary *lef_clib =
+    reinterpret_cast<ConcreteLibrary*>(network->lefLibrary());
+  writer.writeInt(lef_clib->busBrktLeft());
+  writer.writeInt(lef_clib->busBrktRight());
+  Instance *top_inst = network->topInstance();
+  writer.writeString(network->name(network->cell(top_inst)));
+
+  writeSessionPorts(writer, network);
+  UnorderedMap<const Instance*, int> inst_index;
+  writeSessionInstances(writer, network, inst_index);
+  writeSessionNets(writer, network, inst_index);
+}
+
+static void
+writeSessionPorts(SessionWriter &writer,
+		  LefDefNetwork *network)
+{
+  Instance *top_inst = network->topInstance();
+  Cell *top_cell = network->cell(top_inst);
+  // Bus ports are written as bits and grouped again when they are read
+  // like the DEF PINS section.
+  PortSeq ports;
+  CellPortBitIterator *port_iter = network->portBitIterator(top_cell);
+  while (port_iter->hasNext())
+    ports.push_back(port_iter->next());
+  delete port_iter;
+
+  writer.writeUInt(ports.size());
+  for (auto port : ports) {
+    writer.writeString(network->name(port));
+    writer.writeString(network->direction(port)->name());
+    Pin *pin = network->findPin(top_inst, port);
+    bool placed = pin && network->isPlaced(pin);
+    writer.writeBool(placed);
+    if (placed) {
+      DefPt location = network->location(pin);
+      writer.writeInt(location.x());
+      writer.writeInt(location.y());
+    }
+  }
+}
+
+static void
+writeSessionInstances(SessionWriter &writer,
+		      LefDefNetwork *network,
+		      // Return value.
+		      UnorderedMap<const Instance*, int> &inst_index)
+{
+  InstanceSeq insts;
+  InstanceChildIterator *child_iter =
+    network->childIterator(network->topInstance());
+  while (child_iter->hasNext())
+    insts.push_back(child_iter->next());
+  delete child_iter;
+
+  writer.writeUInt(insts.size());
+  for (size_t i = 0; i < insts.size(); i++) {
+    Instance *inst = insts[i];
+    inst_index[inst] = i;
+    Cell *cell = network->cell(inst);
+    writer.writeString(network->name(inst));
+    writer.writeBool(network->isLefCell(cell));
+    writer.writeString(network->name(cell));
+    const DefPlacement *placement = network->placement(inst);
+    writer.writeBool(placement != nullptr);
+    if (placement) {
+      DefPt location = placement->location();
+      writer.writeInt(placement->status());
+      writer.writeInt(location.x());
+      writer.writeInt(location.y());
+      writer.writeInt(placement->orient());
+    }
+    const DefComponentExtra *extra = network->componentExtra(inst);
+    writer.writeBool(extra != nullptr);
+    if (extra)
+      writeSessionComponentExtra(writer, extra);
+  }
+}
+
+static void
+writeSessionComponentExtra(SessionWriter &writer,
+			   const DefComponentExtra *extra)
+{
+  writer.writeString(extra->eeq_);
+  writer.writeString(extra->generate_name_);
+  writer.writeString(extra->generate_macro_);
+  writer.writeString(extra->source_);
+  writer.writeBool(extra->has_foreign_);
+  writer.writeString(extra->foreign_name_);
+  writer.writeInt(extra->foreign_x_);
+  writer.writeInt(extra->foreign_y_);
+  writer.writeString(extra->foreign_orient_);
+  writer.writeBool(extra->has_weight_);
+  writer.writeInt(extra->weight_);
+  writer.writeString(extra->region_name_);
+  writer.writeBool(extra->has_region_bounds_);
+  writer.writeInt(extra->region_lx_);
+  writer.writeInt(extra->region_ly_);
+  writer.writeInt(extra->region_ux_);
+  writer.writeInt(extra->region_uy_);
+}
+
+static void
+writeSessionNets(SessionWriter &writer,
+		 LefDefNetwork *network,
+		 const UnorderedMap<const Instance*, int> &inst_index)
+{
+  NetSeq nets;
+  NetIterator *net_iter = network->netIterator(network->topInstance());
+  while (net_iter->hasNext())
+    nets.push_back(net_iter->next());
+  delete net_iter;
+
+  writer.writeUInt(nets.size());
+  for (auto net : nets) {
+    writer.writeString(network->name(net));
+    PinSeq pins;
+    NetPinIterator *pin_iter = network->pinIterator(net);
+    while (pin_iter->hasNext())
+      pins.push_back(pin_iter->next());
+    delete pin_iter;
+    NetTermIterator *term_iter = network->termIterator(net);
+    while (term_iter->hasNext())
+      pins.push_back(network->pin(term_iter->next()));
+    delete term_iter;
+
+    writer.writeUInt(pins.size());
+    for (auto pin : pins) {
+      int index = -1;
+      bool exists;
+      // Top level ports have index -1.
+      inst_index.findKey(network->instance(pin), index, exists);
+      writer.writeInt(exists ? index : -1);
+      writer.writeString(network->name(network->port(pin)));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+bool
+readSessionNetwork(SessionReader &reader,
+		   LefDefNetwork *network)
+{
+  string def_filename = reader.readString();
+  if (!def_filename.empty())
+    network->setDefFilename(def_filename.c_str());
+  network->setDefUnits(reader.readInt());
+  DefDbu die_lx = reader.readInt();
+  DefDbu die_ly = reader.readInt();
+  DefDbu die_ux = reader.readInt();
+  DefDbu die_uy = reader.readInt();
+  network->setDieArea(die_lx, die_ly, die_ux, die_uy);
+  network->setDivider(reader.readInt());
+  Library *lef_lib = network->lefLibrary();
+  ConcreteLibrary *lef_clib = reinterpret_cast<ConcreteLibrary*>(lef_lib);
+  char bus_left = reader.readInt();
+  char bus_right = reader.readInt();
+  lef_clib->setBusBrkts(bus_left, bus_right);
+  string design = reader.readString();
+  Cell *top_cell = network->makeCell(lef_lib, design.c_str(), false,
+				     network->defFilename());
+  Instance *top_inst = network->makeInstance(top_cell, "", nullptr);
+  network->setTopInstance(top_inst);
+
+  readSessionPorts(reader, network);
+  InstanceSeq insts;
+  readSessionInstances(reader, network, insts);
+  readSessionNets(reader, network, insts);
+  return !reader.error();
+}
+
+static void
+readSessionPorts(SessionReader &reader,
+		 LefDefNetwork *network)
+{
+  Cell *top_cell = network->cell(network->topInstance());
+  uint32_t port_count = reader.readUInt();
+  for (uint32_t i = 0; i < port_count && !reader.error(); i++) {
+    string name = reader.readString();
+    string dir_name = reader.readString();
+    Port *port = network->makePort(top_cell, name.c_str());
+    PortDirection *dir = PortDirection::find(dir_name.c_str());
+    network->setDirection(port, dir ? dir : PortDirection::unknown());
+    if (reader.readBool()) {
+      DefDbu x = reader.readInt();
+      DefDbu y = reader.readInt();
+      network->setLocation(port, DefPt(x, y));
+    }
+  }
+  network->initTopInstancePins();
+  network->groupBusPorts(top_cell);
+}
+
+static void
+readSessionInstances(SessionReader &reader,
+		     LefDefNetwork *network,
+		     // Return value.
+		     InstanceSeq &insts)
+{
+  Library *lef_lib = network->lefLibrary();
+  Report *report = network->report();
+  uint32_t inst_count = reader.readUInt();
+  insts.reserve(inst_count);
+  for (uint32_t i = 0; i < inst_count && !reader.error(); i++) {
+    string name = reader.readString();
+    bool is_lef = reader.readBool();
+    string cell_name = reader.readString();
+    bool has_placement = reader.readBool();
+    int status = 0, orient = 0;
+    DefDbu x = 0, y = 0;
+    if (has_placement) {
+      status = reader.readInt();
+      x = reader.readInt();
+      y = reader.readInt();
+      orient = reader.readInt();
+    }
+    bool has_extra = reader.readBool();
+    DefComponentExtra extra;
+    if (has_extra)
+      readSessionComponentExtra(reader, extra);
+    Cell *cell = nullptr;
+    if (is_lef)
+      cell = network->findCell(lef_lib, cell_name.c_str());
+    else {
+      LibertyCell *liberty_cell = network->findLibertyCell(cell_name.c_str());
+      if (liberty_cell)
+	cell = network->cell(liberty_cell);
+    }
+    Instance *inst = nullptr;
+    if (cell) {
+      inst = network->makeDefComponent(cell, name.c_str(), nullptr);
+      if (has_placement)
+	network->setPlacement(inst, DefPt(x, y), orient, status);
+      if (has_extra)
+	network->setComponentExtra(inst, extra);
+    }
+    else
+      report->printError("Error: instance %s cell %s not found.\n",
+			 name.c_str(),
+			 cell_name.c_str());
+    // Keep the indices aligned with the session.
+    insts.push_back(inst);
+  }
+}
+
+static void
+readSessionComponentExtra(SessionReader &reader,
+			  // Return value.
+			  DefComponentExtra &extra)
+{
+  extra.eeq_ = reader.readString();
+  extra.generate_name_ = reader.readString();
+  extra.generate_macro_ = reader.readString();
+  extra.source_ = reader.readString();
+  extra.has_foreign_ = reader.readBool();
+  extra.foreign_name_ = reader.readString();
+  extra.foreign_x_ = reader.readInt();
+  extra.foreign_y_ = reader.readInt();
+  extra.foreign_orient_ = reader.readString();
+  extra.has_weight_ = reader.readBool();
+  extra.weight_ = reader.readInt();
+  extra.region_name_ = reader.readString();
+  extra.has_region_bounds_ = reader.readBool();
+  extra.region_lx_ = reader.readInt();
+  extra.region_ly_ = reader.readInt();
+  extra.region_ux_ = reader.readInt();
+  extra.region_uy_ = reader.readInt();
+}
+
+static void
+readSessionNets(SessionReader &reader,
+		LefDefNetwork *network,
+		const InstanceSeq &insts)
+{
+  Instance *top_inst = network->topInstance();
+  uint32_t net_count = reader.readUInt();
+  for (uint32_t i = 0; i < net_count && !reader.error(); i++) {
+    string name = reader.readString();
+    Net *net = network->makeNet(name.c_str(), top_inst);
+    uint32_t pin_count = reader.readUInt();
+    for (uint32_t j = 0; j < pin_count && !reader.error(); j++) {
+      int index = reader.readInt();
+      string port_name = reader.readString();
+      if (index < 0) {
+	Pin *pin = network->findPin(top_inst, port_name.c_str());
+	if (pin)
+	  network->makeTerm(pin, net);
+      }
+      else if (static_cast<size_t>(index) < insts.size()
+	       && insts[index]) {
+	Instance *inst = insts[index];
+	Port *port = network->findPort(network->cell(inst), port_name.c_str());
+	if (port)
+	  network->connect(inst, port, net);
+      }
+    }
+  }
+}
+
+} // namespace
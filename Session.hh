@@ -0,0 +1,109 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_SESSION_H
+#define RESIZER_SESSION_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include "MappedFile.hh"
+
+namespace sta {
+
+using std::string;
+
+class LefDefNetwork;
+
+// Session files start with session_magic, session_byte_order and
+// session_version. Readers reject other versions instead of guessing
+// at the layout.
+extern const char session_magic[8];
+static const uint32_t session_byte_order = 0x01020304;
+static const uint32_t session_version = 3;
+
+// Binary session file writer. Values are written in host byte order
+// and readers on a machine with the other byte order swap them.
+class SessionWriter
+{
+public:
+  explicit SessionWriter(const char *filename);
+  // Closes the file without checking for errors if close was not called.
+  ~SessionWriter();
+  // Flush and close the file.
+  // Throws FileNotWritable if any write failed.
+  void close();
+  void writeInt(int32_t value);
+  void writeUInt(uint32_t value);
+  void writeFloat(float value);
+  void writeDouble(double value);
+  void writeBool(bool value);
+  void writeString(const char *str);
+  void writeString(const string &str);
+  void writeHeader();
+
+private:
+  void write(const void *data,
+	     size_t size);
+
+  string filename_;
+  FILE *stream_;
+};
+
+// Session file reader over a read only memory map of the file.
+// Reads past the end of the file return zeros and set error().
+class SessionReader
+{
+public:
+  explicit SessionReader(const char *filename);
+  bool error() const { return error_; }
+  int32_t readInt();
+  uint32_t readUInt();
+  float readFloat();
+  double readDouble();
+  bool readBool();
+  string readString();
+  // Return false if the header is not a session of session_version.
+  bool readHeader();
+
+private:
+  bool read(void *data,
+	    size_t size);
+  // Read size bytes and swap them if the session byte order differs.
+  void readValue(void *data,
+		 size_t size);
+
+  MappedFile file_;
+  size_t offset_;
+  bool error_;
+  // The session was written with the other byte order.
+  bool swap_;
+};
+
+// Instances, nets, ports, locations and DEF component placement
+// and extra fields.
+void
+writeSessionNetwork(SessionWriter &writer,
+		    LefDefNetwork *network);
+// Rebuild the network written by writeSessionNetwork.
+// The LEF and liberty libraries must already be read.
+// Return false if the session is damaged.
+bool
+readSessionNetwork(SessionReader &reader,
+		   LefDefNetwork *network);
+
+} // namespace
+#endif
@@ -0,0 +1,290 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_SPATIAL_INDEX_H
+#define RESIZER_SPATIAL_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include "Vector.hh"
+#include "UnorderedMap.hh"
+
+namespace sta {
+
+// Uniform grid of bins over object locations.
+// LOC is a point class with x() and y() accessors (DefPt).
+// Locations outside the grid bounds are kept in the edge bins, so the
+// bounds only affect the query speed.
+template <class OBJ, class LOC>
+class SpatialIndex
+{
+public:
+  SpatialIndex();
+  void clear();
+  // Size the grid for about object_count objects inside the bounds.
+  void init(int lx,
+	    int ly,
+	    int ux,
+	    int uy,
+	    size_t object_count);
+  size_t size() const { return bin_index_.size(); }
+  // Insert or move obj.
+  void insert(OBJ obj,
+	      LOC loc);
+  void remove(OBJ obj);
+  // Objects with locations inside the window (inclusive).
+  void findInWindow(int lx,
+		    int ly,
+		    int ux,
+		    int uy,
+		    // Return value.
+		    Vector<OBJ> &objs) const;
+  // The count objects nearest to loc, nearest first.
+  void findNearest(LOC loc,
+		   size_t count,
+		   // Return value.
+		   Vector<OBJ> &objs) const;
+
+protected:
+  class Entry
+  {
+  public:
+    OBJ obj_;
+    LOC loc_;
+  };
+  typedef Vector<Entry> EntrySeq;
+
+  int binX(int x) const;
+  int binY(int y) const;
+  int binIndex(LOC loc) const;
+  double distance2(LOC loc1,
+		   LOC loc2) const;
+
+  // Distance squared to the query location and the object entry.
+  typedef std::pair<double, const Entry*> DistEntry;
+  // Nearest first with ties broken by location.
+  class DistEntryLess
+  {
+  public:
+    bool operator()(const DistEntry &entry1,
+		    const DistEntry &entry2) const
+    {
+      if (entry1.first != entry2.first)
+	return entry1.first < entry2.first;
+      const LOC &loc1 = entry1.second->loc_;
+      const LOC &loc2 = entry2.second->loc_;
+      return loc1.x() < loc2.x()
+	|| (loc1.x() == loc2.x()
+	    && loc1.y() < loc2.y());
+    }
+  };
+
+  int lx_;
+  int ly_;
+  int bin_width_;
+  int bin_height_;
+  int x_count_;
+  int y_count_;
+  Vector<EntrySeq> bins_;
+  UnorderedMap<OBJ, int> bin_index_;
+};
+
+// Objects per bin the grid is sized for.
+static const size_t spatial_index_bin_objects = 4;
+
+template <class OBJ, class LOC>
+SpatialIndex<OBJ, LOC>::SpatialIndex() :
+  lx_(0),
+  ly_(0),
+  bin_width_(1),
+  bin_height_(1),
+  x_count_(1),
+  y_count_(1),
+  bins_(1)
+{
+}
+
+template <class OBJ, class LOC>
+void
+SpatialIndex<OBJ, LOC>::clear()
+{
+  bins_.clear();
+  bins_.resize(1);
+  bin_index_.clear();
+  lx_ = ly_ = 0;
+  bin_width_ = bin_height_ = 1;
+  x_count_ = y_count_ = 1;
+}
+
+template <class OBJ, class LOC>
+void
+SpatialIndex<OBJ, LOC>::init(int lx,
+			     int ly,
+			     int ux,
+			     int uy,
+			     size_t object_count)
+{
+  bin_index_.clear();
+  lx_ = lx;
+  ly_ = ly;
+  int side = std::max(1, static_cast<int>(std::sqrt(object_count
+						    / spatial_index_bin_objects)));
+  x_count_ = side;
+  y_count_ = side;
+  bin_width_ = std::max(1, (ux - lx + side - 1) / side);
+  bin_height_ = std::max(1, (uy - ly + side - 1) / side);
+  bins_.clear();
+  bins_.resize(x_count_ * y_count_);
+}
+
+template <class OBJ, class LOC>
+int
+SpatialIndex<OBJ, LOC>::binX(int x) const
+{
+  int bin_x = (x < lx_) ? 0 : (x - lx_) / bin_width_;
+  return std::min(bin_x, x_count_ - 1);
+}
+
+template <class OBJ, class LOC>
+int
+SpatialIndex<OBJ, LOC>::binY(int y) const
+{
+  int bin_y = (y < ly_) ? 0 : (y - ly_) / bin_height_;
+  return std::min(bin_y, y_count_ - 1);
+}
+
+template <class OBJ, class LOC>
+int
+SpatialIndex<OBJ, LOC>::binIndex(LOC loc) const
+{
+  return binY(loc.y()) * x_count_ + binX(loc.x());
+}
+
+template <class OBJ, class LOC>
+void
+SpatialIndex<OBJ, LOC>::insert(OBJ obj,
+			       LOC loc)
+{
+  remove(obj);
+  int index = binIndex(loc);
+  bins_[index].push_back(Entry{obj, loc});
+  bin_index_[obj] = index;
+}
+
+template <class OBJ, class LOC>
+void
+SpatialIndex<OBJ, LOC>::remove(OBJ obj)
+{
+  int index;
+  bool exists;
+  bin_index_.findKey(obj, index, exists);
+  if (exists) {
+    EntrySeq &bin = bins_[index];
+    for (size_t i = 0; i < bin.size(); i++) {
+      if (bin[i].obj_ == obj) {
+	bin[i] = bin.back();
+	bin.pop_back();
+	break;
+      }
+    }
+    bin_index_.erase(obj);
+  }
+}
+
+template <class OBJ, class LOC>
+void
+SpatialIndex<OBJ, LOC>::findInWindow(int lx,
+				     int ly,
+				     int ux,
+				     int uy,
+				     // Return value.
+				     Vector<OBJ> &objs) const
+{
+  int bin_lx = binX(lx);
+  int bin_ux = binX(ux);
+  int bin_ly = binY(ly);
+  int bin_uy = binY(uy);
+  for (int bin_y = bin_ly; bin_y <= bin_uy; bin_y++) {
+    for (int bin_x = bin_lx; bin_x <= bin_ux; bin_x++) {
+      for (const Entry &entry : bins_[bin_y * x_count_ + bin_x]) {
+	int x = entry.loc_.x();
+	int y = entry.loc_.y();
+	if (x >= lx && x <= ux
+	    && y >= ly && y <= uy)
+	  objs.push_back(entry.obj_);
+      }
+    }
+  }
+}
+
+template <class OBJ, class LOC>
+double
+SpatialIndex<OBJ, LOC>::distance2(LOC loc1,
+				  LOC loc2) const
+{
+  double dx = static_cast<double>(loc1.x()) - loc2.x();
+  double dy = static_cast<double>(loc1.y()) - loc2.y();
+  return dx * dx + dy * dy;
+}
+
+// Search rings of bins around the bin containing loc. Objects outside
+// the first r rings are at least r bin widths away, so the search stops
+// when that bound passes the count'th nearest object found so far.
+template <class OBJ, class LOC>
+void
+SpatialIndex<OBJ, LOC>::findNearest(LOC loc,
+				    size_t count,
+				    // Return value.
+				    Vector<OBJ> &objs) const
+{
+  if (count == 0)
+    return;
+  Vector<DistEntry> found;
+  int bin_x0 = binX(loc.x());
+  int bin_y0 = binY(loc.y());
+  int ring_max = std::max(x_count_, y_count_);
+  double bin_min = std::min(bin_width_, bin_height_);
+  for (int ring = 0; ring <= ring_max; ring++) {
+    for (int bin_y = bin_y0 - ring; bin_y <= bin_y0 + ring; bin_y++) {
+      if (bin_y < 0 || bin_y >= y_count_)
+	continue;
+      bool y_edge = (bin_y == bin_y0 - ring || bin_y == bin_y0 + ring);
+      // Interior rows of the ring only have bins on the left and right.
+      int step = y_edge ? 1 : std::max(1, 2 * ring);
+      for (int bin_x = bin_x0 - ring; bin_x <= bin_x0 + ring; bin_x += step) {
+	if (bin_x < 0 || bin_x >= x_count_)
+	  continue;
+	for (const Entry &entry : bins_[bin_y * x_count_ + bin_x])
+	  found.push_back(DistEntry(distance2(loc, entry.loc_), &entry));
+      }
+    }
+    if (found.size() >= count) {
+      std::nth_element(found.begin(), found.begin() + (count - 1), found.end(),
+		       DistEntryLess());
+      double bound = ring * bin_min;
+      if (found[count - 1].first <= bound * bound)
+	break;
+    }
+  }
+  size_t found_count = std::min(count, found.size());
+  std::partial_sort(found.begin(), found.begin() + found_count, found.end(),
+		    DistEntryLess());
+  for (size_t i = 0; i < found_count; i++)
+    objs.push_back(found[i].second->obj_);
+}
+
+} // namespace
+#endif
@@ -0,0 +1,327 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include "Machine.hh"
+#include "Delay.hh"
+#include "Liberty.hh"
+#include "TimingArc.hh"
+#include "TableModel.hh"
+#include "TableBatch.hh"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sta {
+
+static bool
+isSlewAxis(const TableAxis *axis);
+static bool
+isCapAxis(const TableAxis *axis);
+static void
+axisValues(const TableAxis *axis,
+	   // Return value.
+	   FloatSeq &values);
+static size_t
+findAxisIndex(const FloatSeq &axis,
+	      float value);
+static void
+interpolate(const float *y00,
+	    const float *y01,
+	    const float *y10,
+	    const float *y11,
+	    const float *dx1,
+	    const float *dx2,
+	    size_t count,
+	    // Return values.
+	    float *values);
+
+// Points are interpolated in blocks so the gathered table corners
+// stay in cache.
+static const size_t batch_block_size = 64;
+
+TableBatch::TableBatch()
+{
+}
+
+bool
+TableBatch::init(const TableModel *model,
+		 const LibertyCell *cell,
+		 const Pvt *pvt)
+{
+  slew_axis_.clear();
+  cap_axis_.clear();
+  values_.clear();
+  const TableAxis *axis1 = model->axis1();
+  const TableAxis *axis2 = model->axis2();
+  bool slew_first = true;
+  switch (model->order()) {
+  case 0:
+    break;
+  case 1:
+    if (isSlewAxis(axis1))
+      axisValues(axis1, slew_axis_);
+    else if (isCapAxis(axis1)) {
+      axisValues(axis1, cap_axis_);
+      // findValue is positional; the cap is the only axis value.
+      slew_first = false;
+    }
+    else
+      return false;
+    break;
+  case 2:
+    if (isSlewAxis(axis1) && isCapAxis(axis2)) {
+      axisValues(axis1, slew_axis_);
+      axisValues(axis2, cap_axis_);
+    }
+    else if (isCapAxis(axis1) && isSlewAxis(axis2)) {
+      axisValues(axis1, cap_axis_);
+      axisValues(axis2, slew_axis_);
+      slew_first = false;
+    }
+    else
+      return false;
+    break;
+  default:
+    return false;
+  }
+  // Constant axes are represented by a single breakpoint.
+  if (slew_axis_.empty())
+    slew_axis_.push_back(0.0);
+  if (cap_axis_.empty())
+    cap_axis_.push_back(0.0);
+
+  // Sample the model at the breakpoints. Interpolating the samples is
+  // the same as interpolating the table because the model is linear
+  // between breakpoints and the scale factor is a constant.
+  const LibertyLibrary *library = cell->libertyLibrary();
+  size_t cap_count = cap_axis_.size();
+  values_.resize(slew_axis_.size() * cap_count);
+  for (size_t i = 0; i < slew_axis_.size(); i++) {
+    for (size_t j = 0; j < cap_count; j++) {
+      float slew = slew_axis_[i];
+      float cap = cap_axis_[j];
+      float value = slew_first
+	? model->findValue(library, cell, pvt, slew, cap, 0.0)
+	: model->findValue(library, cell, pvt, cap, slew, 0.0);
+      values_[i * cap_count + j] = value;
+    }
+  }
+  return true;
+}
+
+void
+TableBatch::findValues(const float *in_slews,
+		       const float *load_caps,
+		       size_t count,
+		       // Return values.
+		       float *values) const
+{
+  float y00[batch_block_size];
+  float y01[batch_block_size];
+  float y10[batch_block_size];
+  float y11[batch_block_size];
+  float dx1[batch_block_size];
+  float dx2[batch_block_size];
+  size_t slew_count = slew_axis_.size();
+  size_t cap_count = cap_axis_.size();
+  const float *table = &values_[0];
+  for (size_t block = 0; block < count; block += batch_block_size) {
+    size_t block_count = std::min(batch_block_size, count - block);
+    // Gather the table corners for each point.
+    for (size_t k = 0; k < block_count; k++) {
+      size_t i = 0, i1 = 0;
+      float d1 = 0.0;
+      if (slew_count > 1) {
+	float slew = in_slews[block + k];
+	i = findAxisIndex(slew_axis_, slew);
+	i1 = i + 1;
+	d1 = (slew - slew_axis_[i]) / (slew_axis_[i1] - slew_axis_[i]);
+      }
+      size_t j = 0, j1 = 0;
+      float d2 = 0.0;
+      if (cap_count > 1) {
+	float cap = load_caps[block + k];
+	j = findAxisIndex(cap_axis_, cap);
+	j1 = j + 1;
+	d2 = (cap - cap_axis_[j]) / (cap_axis_[j1] - cap_axis_[j]);
+      }
+      y00[k] = table[i * cap_count + j];
+      y01[k] = table[i * cap_count + j1];
+      y10[k] = table[i1 * cap_count + j];
+      y11[k] = table[i1 * cap_count + j1];
+      dx1[k] = d1;
+      dx2[k] = d2;
+    }
+    interpolate(y00, y01, y10, y11, dx1, dx2, block_count, values + block);
+  }
+}
+
+// Bilinear interpolation.
+//  a = y00 + dx2 * (y01 - y00)
+//  b = y10 + dx2 * (y11 - y10)
+//  value = a + dx1 * (b - a)
+static void
+interpolate(const float *y00,
+	    const float *y01,
+	    const float *y10,
+	    const float *y11,
+	    const float *dx1,
+	    const float *dx2,
+	    size_t count,
+	    // Return values.
+	    float *values)
+{
+  size_t k = 0;
+#if defined(__SSE2__)
+  for (; k + 4 <= count; k += 4) {
+    __m128 v00 = _mm_loadu_ps(y00 + k);
+    __m128 v01 = _mm_loadu_ps(y01 + k);
+    __m128 v10 = _mm_loadu_ps(y10 + k);
+    __m128 v11 = _mm_loadu_ps(y11 + k);
+    __m128 d1 = _mm_loadu_ps(dx1 + k);
+    __m128 d2 = _mm_loadu_ps(dx2 + k);
+    __m128 a = _mm_add_ps(v00, _mm_mul_ps(d2, _mm_sub_ps(v01, v00)));
+    __m128 b = _mm_add_ps(v10, _mm_mul_ps(d2, _mm_sub_ps(v11, v10)));
+    __m128 value = _mm_add_ps(a, _mm_mul_ps(d1, _mm_sub_ps(b, a)));
+    _mm_storeu_ps(values + k, value);
+  }
+#endif
+  // Scalar fallback and remainder.
+  for (; k < count; k++) {
+    float a = y00[k] + dx2[k] * (y01[k] - y00[k]);
+    float b = y10[k] + dx2[k] * (y11[k] - y10[k]);
+    values[k] = a + dx1[k] * (b - a);
+  }
+}
+
+// Same as TableAxis::findAxisIndex. Values beyond the ends of the
+// axis use the first/last segment to extrapolate.
+static size_t
+findAxisIndex(const FloatSeq &axis,
+	      float value)
+{
+  size_t size = axis.size();
+  if (size <= 2 || value <= axis[1])
+    return 0;
+  else if (value >= axis[size - 2])
+    return size - 2;
+  else {
+    auto upper = std::upper_bound(axis.begin(), axis.end(), value);
+    return (upper - axis.begin()) - 1;
+  }
+}
+
+static bool
+isSlewAxis(const TableAxis *axis)
+{
+  TableAxisVariable var = axis->variable();
+  return var == TableAxisVariable::input_net_transition
+    || var == TableAxisVariable::input_transition_time;
+}
+
+static bool
+isCapAxis(const TableAxis *axis)
+{
+  return axis->variable() == TableAxisVariable::total_output_net_capacitance;
+}
+
+static void
+axisValues(const TableAxis *axis,
+	   // Return value.
+	   FloatSeq &values)
+{
+  for (size_t i = 0; i < axis->size(); i++)
+    values.push_back(axis->axisValue(i));
+}
+
+////////////////////////////////////////////////////////////////
+
+GateTableBatch::GateTableBatch(const LibertyCell *cell,
+			       TimingArc *arc,
+			       const Pvt *pvt) :
+  cell_(cell),
+  model_(dynamic_cast<GateTimingModel*>(arc->model())),
+  pvt_(pvt),
+  batched_(false)
+{
+  GateTableModel *table_model = dynamic_cast<GateTableModel*>(model_);
+  if (table_model
+      && table_model->delayModel()
+      && table_model->slewModel())
+    batched_ = delay_table_.init(table_model->delayModel(), cell, pvt)
+      && slew_table_.init(table_model->slewModel(), cell, pvt);
+}
+
+void
+GateTableBatch::gateDelays(const FloatSeq &in_slews,
+			   const FloatSeq &load_caps,
+			   // Return values.
+			   FloatSeq &delays,
+			   FloatSeq &slews) const
+{
+  size_t count = load_caps.size();
+  delays.resize(count);
+  slews.resize(count);
+  if (count > 0)
+    gateDelays(&in_slews[0], &load_caps[0], count, &delays[0], &slews[0]);
+}
+
+void
+GateTableBatch::gateDelays(const float *in_slews,
+			   const float *load_caps,
+			   size_t count,
+			   // Return values.
+			   float *delays,
+			   float *slews) const
+{
+  if (batched_) {
+    delay_table_.findValues(in_slews, load_caps, count, delays);
+    slew_table_.findValues(in_slews, load_caps, count, slews);
+    // Clip negative slews to zero like GateTableModel::gateDelay.
+    for (size_t i = 0; i < count; i++)
+      slews[i] = std::max(slews[i], 0.0F);
+  }
+  else if (model_) {
+    for (size_t i = 0; i < count; i++) {
+      ArcDelay delay;
+      Slew slew;
+      model_->gateDelay(cell_, pvt_, in_slews[i], load_caps[i], 0.0, false,
+			delay, slew);
+      delays[i] = delayAsFloat(delay);
+      slews[i] = delayAsFloat(slew);
+    }
+  }
+  else {
+    for (size_t i = 0; i < count; i++) {
+      delays[i] = 0.0;
+      slews[i] = 0.0;
+    }
+  }
+}
+
+void
+GateTableBatch::gateDelay(float in_slew,
+			  float load_cap,
+			  // Return values.
+			  float &delay,
+			  float &slew) const
+{
+  gateDelays(&in_slew, &load_cap, 1, &delay, &slew);
+}
+
+} // namespace
@@ -0,0 +1,97 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+// 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_TABLE_BATCH_H
+#define RESIZER_TABLE_BATCH_H
+
+#include "Vector.hh"
+#include "UnorderedMap.hh"
+#include "LibertyClass.hh"
+
+namespace sta {
+
+class TableModel;
+class GateTimingModel;
+class Pvt;
+
+typedef Vector<float> FloatSeq;
+
+// NLDM table resampled at its own breakpoints (including library
+// scale factors) so that batches of (in_slew, load_cap) points can
+// be interpolated without per-point virtual calls or axis variable
+// dispatch. The interpolation kernel uses SSE2 when it is available.
+class TableBatch
+{
+public:
+  TableBatch();
+  // Return false if the table depends on something other than
+  // the input slew and load capacitance.
+  bool init(const TableModel *model,
+	    const LibertyCell *cell,
+	    const Pvt *pvt);
+  void findValues(const float *in_slews,
+		  const float *load_caps,
+		  size_t count,
+		  // Return values.
+		  float *values) const;
+
+protected:
+  FloatSeq slew_axis_;
+  FloatSeq cap_axis_;
+  // values_[slew_index * cap_axis_.size() + cap_index]
+  FloatSeq values_;
+};
+
+// Batched gate delay/slew evaluation for one timing arc.
+// Arcs that do not use table models fall back to scalar
+// GateTimingModel::gateDelay calls.
+class GateTableBatch
+{
+public:
+  GateTableBatch(const LibertyCell *cell,
+		 TimingArc *arc,
+		 const Pvt *pvt);
+  bool isBatched() const { return batched_; }
+  void gateDelays(const FloatSeq &in_slews,
+		  const FloatSeq &load_caps,
+		  // Return values.
+		  FloatSeq &delays,
+		  FloatSeq &slews) const;
+  void gateDelays(const float *in_slews,
+		  const float *load_caps,
+		  size_t count,
+		  // Return values.
+		  float *delays,
+		  float *slews) const;
+  void gateDelay(float in_slew,
+		 float load_cap,
+		 // Return values.
+		 float &delay,
+		 float &slew) const;
+
+protected:
+  const LibertyCell *cell_;
+  GateTimingModel *model_;
+  const Pvt *pvt_;
+  bool batched_;
+  TableBatch delay_table_;
+  TableBatch slew_table_;
+};
+
+typedef UnorderedMap<TimingArc*, GateTableBatch*> GateTableBatchMap;
+
+} // namespace
+#endif
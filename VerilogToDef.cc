@@ -17,6 +17,8 @@
 #include <inttypes.h>
 #include <cmath> 		// sqrt
 #include <stdlib.h>
+#include <thread>
+#include <exception>
 #include "Machine.hh"
 #include "Report.hh"
 #include "ReportStd.hh"
@@ -26,6 +28,7 @@
 #include "LibertyReader.hh"
 #include "VerilogReader.hh"
 #include "DefWriter.hh"
+#include "CompressedFile.hh"
 #include "LefDefNetwork.hh"
 #include "ResizerConfig.hh" // RESIZER_VERSION
 #include "StaMain.hh" // findCmdLineKey, findCmdLineFlag
@@ -43,6 +46,8 @@ using sta::isDigits;
 using sta::findCmdLineKey;
 using sta::findCmdLineFlag;
 using sta::LefDefNetwork;
+using sta::LibertyReadNetwork;
+using sta::LibertyLibrarySeq;
 using sta::initSta;
 using sta::StaException;
 
@@ -79,6 +84,7 @@ main(int argc,
   Report *report = makeReportStd();
   bool errors = false;
   bool verbose = findCmdLineFlag(argc, argv, "-verbose");
+  bool parallel_read = findCmdLineFlag(argc, argv, "-parallel_read");
 
   StringVector liberty_filenames;
   const char *liberty_filename = findCmdLineKey(argc, argv, "-liberty");
@@ -173,25 +179,82 @@ main(int argc,
     errors = true;
   }
 
+  int compress_level = sta::compress_level_default;
+  const char *compress_level_str = findCmdLineKey(argc, argv, "-compress_level");
+  if (compress_level_str) {
+    compress_level = parseInt(compress_level_str, "-compress_level", report);
+    if (compress_level < 1 || compress_level > 9) {
+      report->printError("Error: -compress_level must be between 1 and 9.\n");
+      errors = true;
+    }
+  }
+
+  int thread_count = 1;
+  const char *threads_str = findCmdLineKey(argc, argv, "-threads");
+  if (threads_str) {
+    thread_count = parseInt(threads_str, "-threads", report);
+    if (thread_count < 1) {
+      report->printError("Error: -threads must be positive.\n");
+      errors = true;
+    }
+  }
+
   if (!errors) {
     Debug debug(report);
     LefDefNetwork network;
     network.initState(report, &debug);
 
     try {
-      bool first = true;
-      for (auto liberty_filename : liberty_filenames) {
-	if (verbose) {
-	  if (!first)
-	    report->print("\n");
-	  report->print("Reading liberty %s...", liberty_filename.c_str());
+      if (parallel_read) {
+	if (verbose)
+	  report->print("Reading liberty and LEF %s...", lef_filename);
+	// The liberty reader thread only touches liberty_network. The
+	// libraries are added to network after the join.
+	LibertyReadNetwork liberty_network(&debug);
+	std::exception_ptr liberty_error;
+	std::thread liberty_thread([&]() {
+	    try {
+	      for (auto liberty_filename : liberty_filenames)
+		liberty_network.readLibertyFile(liberty_filename.c_str(), false);
+	    }
+	    catch (...) {
+	      liberty_error = std::current_exception();
+	    }
+	  });
+	std::exception_ptr lef_error;
+	try {
+	  readLef(lef_filename, false, &network);
 	}
-	readLibertyFile(liberty_filename.c_str(), false, &network);
-	first = false;
+	catch (...) {
+	  lef_error = std::current_exception();
+	}
+	liberty_thread.join();
+	report->print("%s", liberty_network.messages());
+	LibertyLibrarySeq libraries;
+	liberty_network.releaseLibraries(libraries);
+	for (auto library : libraries)
+	  network.addLibertyLibrary(library);
+	if (liberty_error)
+	  std::rethrow_exception(liberty_error);
+	if (lef_error)
+	  std::rethrow_exception(lef_error);
+	network.linkLibertyCells();
+      }
+      else {
+	bool first = true;
+	for (auto liberty_filename : liberty_filenames) {
+	  if (verbose) {
+	    if (!first)
+	      report->print("\n");
+	    report->print("Reading liberty %s...", liberty_filename.c_str());
+	  }
+	  readLibertyFile(liberty_filename.c_str(), false, &network);
+	  first = false;
+	}
+	if (verbose)
+	  report->print("\nReading LEF %s...", lef_filename);
+	readLef(lef_filename, true, &network);
       }
-      if (verbose)
-	report->print("\nReading LEF %s...", lef_filename);
-      readLef(lef_filename, &network);
 
       if (verbose)
 	report->print("\nReading verilog %s...", verilog_filename);
@@ -240,7 +303,7 @@ main(int argc,
 	       die_lx, die_ly, die_ux, die_uy,
 	       core_lx, core_ly, core_ux, core_uy,
 	       site_name, tracks_file, auto_place_pins, true,
-	       &network);
+	       compress_level, thread_count, &network);
       if (verbose)
 	report->print("\n");
     }
@@ -261,6 +324,7 @@ showUsage(const char *prog)
   printf("  [-help]                    show help and exit\n");
   printf("  [-version]                 show version and exit\n");
   printf("  [-verbose]                 report progress\n");
+  printf("  [-parallel_read]           read liberty and lef concurrently\n");
   printf("  -liberty liberty_file      liberty for linking verilog\n");
   printf("  -lef lef_file              lef_file for site size\n");
   printf("  -verilog verilog_file      \n");
@@ -276,7 +340,9 @@ showUsage(const char *prog)
   printf("\n");
   printf("  [-site site_name]          \n");
   printf("  [-auto_place_pins]         \n");
-  printf("  -def def_file              def file to write\n");
+  printf("  -def def_file              def file to write (.gz to compress)\n");
+  printf("  [-compress_level level]    gzip level 1-9, default 6\n");
+  printf("  [-threads count]           threads used to compress, default 1\n");
 }
 
 static double
@@ -0,0 +1,31 @@
+# write_def_shards/merge_def_shards round trip
+source helpers.tcl
+read_liberty liberty1.lib
+read_lef liberty1.lef
+read_def reg3.def
+
+set before_file [make_result_file def_shards1_before.def]
+write_def -sort $before_file
+
+set shard_dir [make_result_file def_shards1]
+file delete -force $shard_dir
+write_def_shards -shards 2 -sort $shard_dir
+puts "shards [llength [glob -directory $shard_dir shard*.def]]"
+puts "sdc files [llength [glob -nocomplain -directory $shard_dir shard*.sdc]]"
+# Shards that were not changed merge back to the same design.
+foreach shard_file [glob -directory $shard_dir shard*.def] {
+  file copy $shard_file "[file rootname $shard_file]_resized.def"
+}
+# The merge messages include the result directory.
+sta::redirect_string_begin
+merge_def_shards $shard_dir
+sta::redirect_string_end
+
+set after_file [make_result_file def_shards1_after.def]
+write_def -sort $after_file
+
+if { [read_file $before_file] == [read_file $after_file] } {
+  puts "merged design matches"
+} else {
+  puts "merged design differs"
+}
@@ -0,0 +1,24 @@
+# read_def -skip keeps the netlist and placement of a full read
+source helpers.tcl
+
+# Read def_skip1.def in a new resizer process and write the DEF and verilog.
+proc read_def_skip { read_args root } {
+  run_resizer_process $root \
+    [list [list read_liberty liberty1.lib] \
+       [list read_lef liberty1.lef] \
+       [concat read_def $read_args def_skip1.def]]
+}
+
+set skip "-skip routing,specialnets,fills,blockages"
+read_def_skip {} def_skip1_full
+foreach {read_args root} [list \
+			    $skip def_skip1_skip \
+			    "-fast" def_skip1_fast \
+			    "-fast $skip" def_skip1_fast_skip] {
+  read_def_skip $read_args $root
+  if { [result_files_match def_skip1_full $root] } {
+    puts "$root match"
+  } else {
+    puts "$root differ"
+  }
+}
@@ -0,0 +1,34 @@
+# estimate_replace_cell, estimate_insert_buffer
+read_liberty liberty1.lib
+read_verilog resize_timing_driven1.v
+link_design top
+create_clock -name clk -period 1 clk
+set_input_delay -clock clk 0 {in1 in2}
+# no placement, so add loads
+set_load .3 [get_nets {u1z u2z u3z u4z}]
+sta::resizer_preamble [get_libs liberty1]
+
+proc check_estimate { name estimate } {
+  if { [llength $estimate] == 4 } {
+    lassign $estimate delay slew load_cap required_delta
+    puts "$name delay [expr $delay > 0] slew [expr $slew > 0] required_delta [format %.3f $required_delta]"
+  } else {
+    puts "$name rejected"
+  }
+}
+
+# Same cell changes nothing.
+set estimate [estimate_replace_cell u3 snl_nand02x1]
+lset estimate 3 [expr abs([lindex $estimate 3])]
+check_estimate "u3 snl_nand02x1" $estimate
+# Upsizing a heavily loaded gate is faster.
+set estimate [estimate_replace_cell u3 snl_nand02x2]
+puts "u3 snl_nand02x2 improves [expr [lindex $estimate 3] > 0]"
+# Not equivalent.
+check_estimate "u3 snl_and02x1" [estimate_replace_cell u3 snl_and02x1]
+check_estimate "u2 snl_bufx2" [estimate_replace_cell u2 snl_bufx2]
+
+# Drivers only.
+set estimate [estimate_insert_buffer u1/Z snl_bufx2]
+puts "u1/Z snl_bufx2 [llength $estimate]"
+check_estimate "u1/A snl_bufx2" [estimate_insert_buffer u1/A snl_bufx2]
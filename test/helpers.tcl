@@ -22,3 +22,42 @@ proc make_result_file { filename } {
   variable result_dir
   return [file join $result_dir $filename]
 }
+
+proc read_file { filename } {
+  set stream [open $filename r]
+  set text [read $stream]
+  close $stream
+  return $text
+}
+
+# Run commands in a new resizer process, for commands like read_session
+# that need an empty design or resizer options like -threads. The
+# process then writes root.def and/or root.v to the results directory
+# for each of exts.
+proc run_resizer_process { root commands { exts {def v} } { options {} } } {
+  set script_file [make_result_file $root.tcl]
+  set stream [open $script_file w]
+  foreach command $commands {
+    puts $stream $command
+  }
+  foreach ext $exts {
+    if { $ext == "def" } {
+      puts $stream [list write_def -sort [make_result_file $root.def]]
+    } elseif { $ext == "v" } {
+      puts $stream [list write_verilog [make_result_file $root.v]]
+    }
+  }
+  close $stream
+  exec [info nameofexecutable] {*}$options -exit $script_file
+}
+
+# Return 1 if result files root1.ext and root2.ext match for each of exts.
+proc result_files_match { root1 root2 { exts {def v} } } {
+  foreach ext $exts {
+    if { [read_file [make_result_file $root1.$ext]] \
+	   != [read_file [make_result_file $root2.$ext]] } {
+      return 0
+    }
+  }
+  return 1
+}
@@ -0,0 +1,38 @@
+# read_def -fast builds the same design as the Si2 reader
+source helpers.tcl
+
+# Read def_file in a new resizer process and write the DEF and verilog.
+proc read_def_write { liberty_file lef_file def_file fast root } {
+  if { $fast } {
+    set read_def [list read_def -fast $def_file]
+  } else {
+    set read_def [list read_def $def_file]
+  }
+  run_resizer_process $root \
+    [list [list read_liberty $liberty_file] \
+       [list read_lef $lef_file] \
+       $read_def]
+}
+
+foreach {liberty_file lef_file def_file} {
+  bus1.lib bus1.lef bus1.def
+  liberty1.lib liberty1.lef rebuffer1.def
+  liberty1.lib liberty1.lef rebuffer2.def
+  liberty1.lib liberty1.lef rebuffer7.def
+  liberty1.lib liberty1.lef reg1.def
+  liberty1.lib liberty1.lef reg2.def
+  liberty1.lib liberty1.lef reg3.def
+  liberty1.lib liberty1.lef reg4.def
+  liberty1.lib liberty1.lef session1.def
+  liberty1.lib liberty1.lef write_verilog6.def
+} {
+  set root [file rootname $def_file]
+  read_def_write $liberty_file $lef_file $def_file 1 read_def_fast1_${root}_fast
+  read_def_write $liberty_file $lef_file $def_file 0 read_def_fast1_${root}_si2
+  if { [result_files_match read_def_fast1_${root}_fast \
+	 read_def_fast1_${root}_si2] } {
+    puts "$def_file match"
+  } else {
+    puts "$def_file differ"
+  }
+}
@@ -0,0 +1,11 @@
+# read_design_files matches sequential reads (write_def1)
+source helpers.tcl
+read_design_files -liberty liberty1.lib -lef liberty1.lef -def reg1.def
+
+set def_file [make_result_file read_design_files1.def]
+write_def $def_file
+report_file $def_file
+# LEF macros are linked to the liberty cells.
+foreach inst [get_cells *] {
+  puts "[get_full_name $inst] [get_name [$inst liberty_cell]]"
+}
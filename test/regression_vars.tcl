@@ -119,10 +119,15 @@ proc list_delete { list delete } {
 
 # Record tests in resizer/test
 record_resizer_tests {
+  def_shards1
+  def_skip1
+  estimate1
   insert_buffer1
   make_parasitics1
   read_def1
   read_def2
+  read_def_fast1
+  read_design_files1
   rebuffer1
   rebuffer2
   rebuffer4
@@ -132,12 +137,19 @@ record_resizer_tests {
   rebuffer8
   rebuffer9
   rebuffer_ports1
+  rollback1
   resize1
   resize2
   resize3
   resize4
   resize5
   resize6
+  resize_tiles1
+  resize_timing_driven1
+  sdc_patterns1
+  session1
+  spatial_index1
+  table_batch1
   write_def1
   write_def2
   write_def3
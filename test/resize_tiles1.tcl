@@ -0,0 +1,99 @@
+# resize -tiles gives the same result for any thread count
+source helpers.tcl
+
+# An 8 x 8 array of registers driving fanout groups so most nets are
+# inside one tile. Some groups and the in1 and clk nets cross tiles.
+proc write_tiles_def { fanout filename } {
+  set groups 64
+  set stream [open $filename "w"]
+  puts $stream {VERSION 5.5 ;
+NAMESCASESENSITIVE ON ;
+DIVIDERCHAR "/" ;
+BUSBITCHARS "[]" ;
+
+DESIGN tiles ;
+TECHNOLOGY technology ;
+
+UNITS DISTANCE MICRONS 1000 ;
+
+DIEAREA ( 0 0 ) ( 80000 80000 ) ;
+}
+  puts $stream "COMPONENTS [expr $groups * ($fanout + 1)] ;"
+  for {set g 0} {$g < $groups} {incr g} {
+    set x [expr ($g % 8) * 10000 + 1000]
+    set y [expr ($g / 8) * 10000 + 1000]
+    puts $stream "- d$g snl_ffqx1 + PLACED ( $x $y ) N ;"
+    for {set i 0} {$i < $fanout} {incr i} {
+      set lx [expr $x + ($i % 4) * 2000]
+      set ly [expr $y + ($i / 4 + 1) * 2000]
+      puts $stream "- l${g}_$i snl_ffqx1 + PLACED ( $lx $ly ) N ;"
+    }
+  }
+  puts $stream "END COMPONENTS"
+  puts $stream {
+PINS 2 ;
+- in1 + NET in1 + DIRECTION INPUT + USE SIGNAL
+  + LAYER M1 ( -100 0 ) ( 100 1040 ) + FIXED ( 0 40000 ) N ;
+- clk + NET clk + DIRECTION INPUT + USE SIGNAL
+  + LAYER M1 ( -100 0 ) ( 100 1040 ) + FIXED ( 0 0 ) N ;
+END PINS
+}
+  puts $stream "NETS [expr $groups + 2] ;"
+  puts -nonewline $stream "- in1 ( PIN in1 )"
+  for {set g 0} {$g < $groups} {incr g} {
+    puts -nonewline $stream "\n ( d$g D )"
+  }
+  puts $stream " ;"
+  puts -nonewline $stream "- clk ( PIN clk )"
+  for {set g 0} {$g < $groups} {incr g} {
+    puts -nonewline $stream "\n ( d$g CP )"
+    for {set i 0} {$i < $fanout} {incr i} {
+      puts -nonewline $stream " ( l${g}_$i CP )"
+    }
+  }
+  puts $stream " ;"
+  for {set g 0} {$g < $groups} {incr g} {
+    puts -nonewline $stream "- n$g ( d$g Q )"
+    for {set i 0} {$i < $fanout} {incr i} {
+      puts -nonewline $stream " ( l${g}_$i D )"
+    }
+    puts $stream " ;"
+  }
+  puts $stream "END NETS"
+  puts $stream "END DESIGN"
+  close $stream
+}
+
+set def_file [make_result_file resize_tiles1.def]
+write_tiles_def 12 $def_file
+
+# Resize def_file in a new process with threads worker threads.
+proc resize_tiles { root resize_args threads } {
+  global def_file
+  run_resizer_process $root \
+    [list [list read_liberty liberty1.lib] \
+       [list read_lef liberty1.lef] \
+       [list read_def $def_file] \
+       [list create_clock clk -period 1] \
+       [list set_wire_rc -resistance 1.7e-4 -capacitance 1.3e-2] \
+       [list set_design_size -core {1 1 79 79}] \
+       [concat resize $resize_args -buffer_cell liberty1/snl_bufx2]] \
+    {def v} [list -threads $threads]
+}
+
+resize_tiles resize_tiles1_resize -resize 1
+resize_tiles resize_tiles1_resize_tiles "-resize -tiles 3" 4
+if { [result_files_match resize_tiles1_resize resize_tiles1_resize_tiles] } {
+  puts "tiled resize matches"
+} else {
+  puts "tiled resize differs"
+}
+
+set rebuffer_args "-repair_max_cap -repair_max_slew -tiles 3"
+resize_tiles resize_tiles1_rebuffer1 $rebuffer_args 1
+resize_tiles resize_tiles1_rebuffer4 $rebuffer_args 4
+if { [result_files_match resize_tiles1_rebuffer1 resize_tiles1_rebuffer4] } {
+  puts "tiled rebuffer matches"
+} else {
+  puts "tiled rebuffer differs"
+}
@@ -0,0 +1,40 @@
+# resize -timing_driven -max_utilization -dont_use
+read_liberty liberty1.lib
+read_verilog resize_timing_driven1.v
+link_design top
+create_clock -name clk -period 1 clk
+set_input_delay -clock clk 0 {in1 in2}
+# no placement, so add loads
+set_load .3 [get_nets {u1z u2z u3z u4z}]
+# 50% utilization before resizing
+set_design_size -core "0 0 10 10"
+
+set wns_before [sta::worst_slack max]
+# The resize count depends on the multipliers, so it is not reported.
+sta::redirect_string_begin
+resize -timing_driven -max_utilization 53 -dont_use liberty1/snl_invx2
+sta::redirect_string_end
+set wns_after [sta::worst_slack max]
+
+if { $wns_after > $wns_before } {
+  puts "wns improved"
+} else {
+  puts "wns not improved $wns_before $wns_after"
+}
+set util [sta::utilization]
+if { $util <= 0.53 } {
+  puts "utilization ok"
+} else {
+  puts "utilization over $util"
+}
+set dont_use_insts {}
+foreach inst [get_cells *] {
+  if { [get_property $inst ref_name] == "snl_invx2" } {
+    lappend dont_use_insts [get_full_name $inst]
+  }
+}
+if { $dont_use_insts == {} } {
+  puts "dont_use ok"
+} else {
+  puts "dont_use used $dont_use_insts"
+}
@@ -0,0 +1,13 @@
+module top (in1, in2, clk, out);
+  input in1, in2, clk;
+  output out;
+  wire r1q, u1z, u2z, u3z, u4z, u5z;
+
+  snl_ffqx1 r1 (.D(in1), .CP(clk), .Q(r1q));
+  snl_bufx1 u1 (.A(r1q), .Z(u1z));
+  snl_invx1 u2 (.A(u1z), .Z(u2z));
+  snl_nand02x1 u3 (.A(u2z), .B(in2), .Z(u3z));
+  snl_invx1 u4 (.A(u3z), .Z(u4z));
+  snl_bufx1 u5 (.A(u4z), .Z(u5z));
+  snl_ffqx1 r2 (.D(u5z), .CP(clk), .Q(out));
+endmodule // top
@@ -0,0 +1,37 @@
+# checkpoint_edits/rollback_edits restore the netlist and buffer names
+source helpers.tcl
+read_liberty liberty1.lib
+read_lef liberty1.lef
+read_def reg3.def
+create_clock -name clk -period 1 clk
+set_input_delay -clock clk 0 in1
+set_load .3 [get_nets u1z]
+
+set before_file [make_result_file rollback1_before.def]
+write_def -sort $before_file
+
+checkpoint_edits
+sta::redirect_string_begin
+resize -buffer_inputs -buffer_outputs -resize -buffer_cell liberty1/snl_bufx2
+sta::redirect_string_end
+puts "buffers [llength [get_cells -quiet buffer*]]"
+sta::redirect_string_begin
+rollback_edits
+sta::redirect_string_end
+puts "have checkpoint [have_edit_checkpoint]"
+
+set after_file [make_result_file rollback1_after.def]
+write_def -sort $after_file
+if { [read_file $before_file] == [read_file $after_file] } {
+  puts "rolled back design matches"
+} else {
+  puts "rolled back design differs"
+}
+
+# The names allocated after the checkpoint are allocated again.
+sta::redirect_string_begin
+resize -buffer_inputs -buffer_cell liberty1/snl_bufx2
+sta::redirect_string_end
+foreach inst [get_cells buffer*] {
+  puts [get_full_name $inst]
+}
@@ -0,0 +1,27 @@
+# wildcard get_cells/get_nets/get_pins after network edits
+source read_reg1.tcl
+
+proc object_names { objects } {
+  set names {}
+  foreach object $objects {
+    lappend names [get_full_name $object]
+  }
+  return [lsort $names]
+}
+
+puts [object_names [get_cells u*]]
+puts [object_names [get_nets r*]]
+
+make_net b1z
+make_instance b1 snl_bufx1
+puts [object_names [get_cells b*]]
+puts [object_names [get_cells *1]]
+puts [object_names [get_nets b*]]
+puts [object_names [get_pins b1/*]]
+puts [object_names [get_pins */Z]]
+
+delete_instance b1
+delete_net b1z
+puts [llength [get_cells -quiet b*]]
+puts [llength [get_nets -quiet b*]]
+puts [object_names [get_cells *1]]
@@ -0,0 +1,20 @@
+# write_session/read_session round trip
+source helpers.tcl
+read_liberty liberty1.lib
+read_lef liberty1.lef
+read_def session1.def
+
+write_def -sort [make_result_file session1_before.def]
+
+set session_file [make_result_file session1.session]
+write_session $session_file
+puts "session written [file exists $session_file]"
+
+# read_session requires an empty design so it runs in a new process.
+run_resizer_process session1_after [list [list read_session $session_file]] def
+
+if { [result_files_match session1_before session1_after def] } {
+  puts "restored design matches"
+} else {
+  puts "restored design differs"
+}
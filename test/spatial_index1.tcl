@@ -0,0 +1,20 @@
+# placed instance and port location queries
+read_liberty liberty1.lib
+read_lef liberty1.lef
+read_def rebuffer1.def
+
+proc object_names { objects } {
+  set names {}
+  foreach object $objects {
+    lappend names [get_full_name $object]
+  }
+  return $names
+}
+
+# r1 100,100 r2 100,200 r3 100,300 r4 100,400 r5 100,500
+puts [lsort [object_names [find_instances_in_window 0 150 1000 350]]]
+puts [object_names [find_nearest_instances -count 3 100 320]]
+puts [object_names [find_nearest_instances 100 90]]
+# clk 100,100
+puts [object_names [find_ports_in_window 0 0 200 200]]
+puts [object_names [find_nearest_ports 500 500]]
@@ -0,0 +1,13 @@
+# table batches match the scalar gate models
+# 1-D cap, 1-D slew and 2-D tables in both axis orders
+read_liberty table_batch1.lib
+
+foreach cell_name {buf_slew_cap buf_cap_slew buf_cap buf_slew} {
+  set cell [get_lib_cell table_batch1/$cell_name]
+  set error [sta::table_batch_error $cell]
+  if { $error >= 0.0 && $error < 1e-4 } {
+    puts "$cell_name pass"
+  } else {
+    puts "$cell_name fail $error"
+  }
+}